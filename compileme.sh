@@ -1 +1,7 @@
-g++ -std=c++11 -I../galib sudoku.cpp -L../galib/ga -lga -o sudoku
+CORE="sudoku_core.cpp sudoku_propagation.cpp sudoku_search.cpp sudoku_simd.cpp sudoku_solver.cpp sudoku_variant.cpp"
+g++ -std=c++11 -I../galib sudoku.cpp $CORE -L../galib/ga -lga -pthread -o sudoku
+g++ -std=c++11 -O2 -I../galib sudoku_benchmark.cpp $CORE -L../galib/ga -lga -pthread -o sudoku_benchmark
+g++ -std=c++11 -O2 sudoku_solve.cpp $CORE -o sudoku_solve
+g++ -std=c++11 -O2 sudoku_lowclue_main.cpp $CORE -pthread -o sudoku_lowclue
+g++ -std=c++11 -O2 sudoku_analysis_main.cpp $CORE -pthread -o sudoku_analyze
+g++ -std=c++11 -O2 sudoku_daemon_main.cpp $CORE -pthread -o sudoku_daemon
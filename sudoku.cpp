@@ -1,20 +1,17 @@
-#include <ga/GA1DArrayGenome.h>
-#include <ga/GASimpleGA.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <ctime>
-#include <cstdlib>
 #include <iostream>
-#include <random>
-#include "sudoku_solver.cpp"
+#include <memory>
+#include "sudoku_ga.cpp"
+#include "sudoku_canonical.cpp"
+#include "sudoku_telemetry.cpp"
+#include "sudoku_checkpoint.cpp"
+#include "sudoku_config.cpp"
 
 using namespace std;
 
-const int POPULATION_SIZE = 20000;
-const int MAX_GENERATIONS = 5000;
-const float CROSSOVER_PROBABILITY = 0.01;
-float MUTATION_PROBABILITY = 0.05;
-
-int **grid;
-
 /*Please create sudoku boards that can be solved in a unique way (there is only one solution) in C++.
 The lesser numbers there are in the sudoku the better - the more complex the sudoku is the better
 (complexity can be measured in how much choices there are in the CSP (contrain-satisfactory-problem)
@@ -32,264 +29,281 @@ optional: If your sudoku solver is able to return "the choices made" during solv
  the more complex is the sudoku-problem - therefore the better the sudoku.*/
 
 
-// Convert the genome to a Sudoku grid
-void genomeToGrid(const GA1DArrayGenome<int> &genome) {
-    for (int i = 0; i < N; ++i) {
-        for (int j = 0; j < N; ++j) {
-            grid[i][j] = genome.gene(i * N + j);
-        }
+unique_ptr<GAEngine> createEngine(const GAConfig &config, unsigned int seed) {
+    if (config.engine == "steady-state") {
+        SteadyStateParameters parameters;
+        parameters.populationSize = config.populationSize;
+        parameters.crossoverProbability = config.crossoverProbability;
+        parameters.mutationProbability = config.mutationProbability;
+        parameters.tournamentSize = config.tournamentSize;
+        parameters.replacementRate = config.replacementRate;
+        parameters.eliteCount = config.eliteCount;
+        parameters.threads = config.threads;
+        parameters.seed = seed;
+        parameters.seedGrids = &seedGrids;
+        parameters.seedFraction = seedFraction;
+        return unique_ptr<GAEngine>(new SteadyStateEngine(parameters));
     }
+    return unique_ptr<GAEngine>(new GAlibEngine(config.crossoverProbability, config.mutationProbability));
 }
 
-// Objective function
-float objective(GAGenome &g) {
-    auto &genome = (GA1DArrayGenome<int> &) g;
-    genomeToGrid(genome);
-
-    if (checkSudoku(grid)) {
-        return N * N * N * 2;
-    } else {
-        // Check how many numbers are incorrect
-        int fitness = N * N * N;
-        for (int row = 0; row < N; row++) {
-            for (int col = 0; col < N; col++) {
-                int num = grid[row][col];
-                // Check if the number is repeated in the same row, column or box
-                int repetitions = isNumberRepeated(row, col, num, grid);
-                if (repetitions > 0) {
-                    fitness = fitness - repetitions;
-                }
-            }
-        }
-        return (float) fitness;
-    }
+ControlSettings controlSettings(const GAConfig &config) {
+    ControlSettings settings;
+    settings.initialPopulationSize = config.populationSize;
+    settings.initialMutationProbability = config.mutationProbability;
+    settings.stallGenerations = config.stallGenerations;
+    settings.generationDecrement = config.generationDecrement;
+    settings.populationDecrement = config.populationDecrement;
+    settings.minPopulationSize = config.minPopulationSize;
+    settings.maxPopulationSize = config.maxPopulationSize;
+    settings.mutationIncrement = config.mutationIncrement;
+    settings.maxMutationProbability = config.maxMutationProbability;
+    settings.minDiversity = config.minDiversity;
+    settings.restartKeepFraction = config.restartEliteFraction;
+    return settings;
 }
 
-void fillRemainingCells() {
-    for (int row = 0; row < N; ++row) {
-        for (int col = 0; col < N; ++col) {
-            std::vector<int> randomValues;
-            for (int i = 1; i <= N; ++i) {
-                randomValues.push_back(i);
-            }
-            random_device rd;
-            mt19937 generator(rd());
-            shuffle(randomValues.begin(), randomValues.end(), generator);
+// Generations between two diversity measurements for the controller
+const int DIVERSITY_INTERVAL = 10;
+
+// Progress of a batch of puzzles, the part of a checkpoint besides the run in progress
+struct BatchState {
+    int run = 0; // index of the run in progress
+    PuzzleSet puzzles; // canonical forms of the puzzles output so far, equivalent puzzles are only output once
+    int duplicates = 0;
+};
+
+// telemetryBytes is the length of the telemetry file at the snapshot, a resume cuts the file back to it
+void saveBatch(CheckpointWriter &out, unsigned int seed, const BatchState &batch, long long telemetryBytes) {
+    out.put(seed);
+    out.put(batch.run);
+    batch.puzzles.saveState(out);
+    out.put(batch.duplicates);
+    out.put(telemetryBytes);
+}
 
-            if (grid[row][col] == 0) {
-                for (int i = 0; i < N; ++i) {
-                    if (!isPresentInRow(row, randomValues[i], grid)) {
-                        grid[row][col] = randomValues[i];
-                        break;
-                    }
-                }
-            }
-        }
-    }
+bool loadBatch(CheckpointReader &in, unsigned int &seed, BatchState &batch, long long &telemetryBytes) {
+    in.get(seed);
+    in.get(batch.run);
+    batch.puzzles.loadState(in);
+    in.get(batch.duplicates);
+    in.get(telemetryBytes);
+    return in.good();
 }
 
-// Initializer
-void initializer(GAGenome &g) {
-    auto &genome = (GA1DArrayGenome<int> &) g;
+// Evolve a filled grid with the GA and copy the best individual into result. With resumeFrom the run
+// continues from the checkpoint instead of a new population, returns false if it cannot be restored.
+bool evolveGrid(GA1DArrayGenome<int> &result, const GAConfig &config, Telemetry &telemetry, unsigned int seed,
+                const BatchState &batch, CheckpointTimer &checkpoints, CheckpointReader *resumeFrom) {
+    int run = batch.run + 1;
+    unique_ptr<GAEngine> ga = createEngine(config, seed + batch.run);
+    unique_ptr<AdaptiveController> controller = createController(config.control, controlSettings(config));
 
-    grid = new int *[N];
-    for (int i = 0; i < N; ++i) {
-        grid[i] = new int[N];
-        for (int j = 0; j < N; ++j) {
-            grid[i][j] = 0;  // Initialize to 0 initially
+    ControlDecision decision{config.populationSize, config.mutationProbability, config.maxGenerations, false, 0.0f};
+    float bestFitness = 0.0;
+    float diversity = 1.0;
+    int restarts = 0;
+    int generation = 0;
+    double resumedSeconds = 0.0;
+
+    if (resumeFrom) {
+        CheckpointReader &in = *resumeFrom;
+        in.get(generation);
+        in.get(decision.populationSize);
+        in.get(decision.mutationProbability);
+        in.get(decision.maxGenerations);
+        in.get(bestFitness);
+        in.get(diversity);
+        in.get(restarts);
+        in.get(resumedSeconds);
+        if (!controller->loadState(in) || !ga->loadState(in) || !in.ok()) {
+            cerr << "Cannot resume from checkpoint " << checkpoints.path() << endl;
+            return false;
         }
+        cout << "Resuming run " << run << " at generation " << generation << endl;
+    } else {
+        ga->initialize();
     }
 
-    // Set values in each box so that each number from 1 to N appears exactly once
-    for (int box = 0; box < 3; ++box) {
-        std::vector<int> boxValues;
-        for (int i = 1; i <= N; ++i) {
-            boxValues.push_back(i);
-        }
+    auto start = chrono::steady_clock::now() -
+                 chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(resumedSeconds));
+    double lastSampleSeconds = 0.0;
+    long long lastSampleEvaluations = ga->evaluationCount();
+    long long lastSampleHits, lastSampleMisses;
+    ga->cacheCounts(lastSampleHits, lastSampleMisses);
 
-        // Shuffle the values for the current box
-        random_device rd;
-        mt19937 generator(rd());
-        shuffle(boxValues.begin(), boxValues.end(), generator);
+    while (generation < decision.maxGenerations) {
+        // Apply the parameters chosen by the controller
+        ga->setPopulationSize(decision.populationSize);
+        ga->setRemainingGenerations(decision.maxGenerations - generation);
 
-        // Set the shuffled values in the current box
-        for (int row = 0; row < 3; ++row) {
-            for (int col = 0; col < 3; ++col) {
-                grid[box * 3 + row][col + box * 3] = boxValues[row * 3 + col];
-            }
-        }
-    }
-    fillRemainingCells();
+        // Evolve for the current generation
+        ga->step();
+        generation++;
 
-// Set the genome with the values from the grid
-    for (int i = 0; i < N; ++i) {
-        for (int j = 0; j < N; ++j) {
-            genome.gene(i * N + j, grid[i][j]);
-        }
-    }
-}
+        float currentBestFitness = ga->bestFitness();
 
-// Mutator
-int mutator(GAGenome &g, float p) {
-    auto &genome = (GA1DArrayGenome<int> &) g;
-    int nMutations = 0;
-    if (GAFlipCoin(p)) {
-        // Pick two random positions
-        int pos1 = rand() % (N * N);
-        int pos2 = rand() % (N * N);
-        // Ensure pos1 and pos2 are different
-        while (pos2 == pos1) {
-            pos2 = rand() % (N * N);
+        if (config.progress) {
+            cout << "Generation " << generation << ": Fitness = " << currentBestFitness << '\n';
         }
-        int tmp = genome.gene(pos1);
-        genome.gene(pos1, genome.gene(pos2));
-        genome.gene(pos2, tmp);
-
-        nMutations++;
-    }
-    return nMutations;
-}
-
-// Crossover
-int crossover(const GAGenome &p1, const GAGenome &p2, GAGenome *c1, GAGenome *c2) {
-    auto &parent1 = (GA1DArrayGenome<int> &) p1;
-    auto &parent2 = (GA1DArrayGenome<int> &) p2;
-    if (c1 && c2) {
-        auto &child1 = (GA1DArrayGenome<int> &) *c1;
-        auto &child2 = (GA1DArrayGenome<int> &) *c2;
-
-        // cut at the end of line 3 or 6
-        int cut = ((rand() % 2) + 1) * 3 * N;
-        for (int i = 0; i < N * N; i++) {
-            if (i < cut) {
-                child1.gene(i, parent1.gene(i));
-                child2.gene(i, parent2.gene(i));
-            } else {
-                child1.gene(i, parent2.gene(i));
-                child2.gene(i, parent1.gene(i));
-            }
+        bool sampled = telemetry.samples(generation - 1);
+        if (sampled || generation % DIVERSITY_INTERVAL == 0) {
+            diversity = populationDiversity(ga->packedPopulation());
         }
-        return 2;
-    } else if (c1) {
-        auto &child = (GA1DArrayGenome<int> &) *c1;
-        int cut = rand() % (N * N);
-        for (int i = 0; i < N * N; i++) {
-            if (i < cut) {
-                child.gene(i, parent1.gene(i));
-            } else {
-                child.gene(i, parent2.gene(i));
-            }
+        if (sampled) {
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            long long evaluated = ga->evaluationCount();
+            long long hits, misses;
+            ga->cacheCounts(hits, misses);
+            GenerationStats stats{};
+            stats.run = run;
+            stats.generation = generation;
+            stats.wallSeconds = seconds;
+            stats.evaluationsPerSecond = seconds > lastSampleSeconds ?
+                                         (double) (evaluated - lastSampleEvaluations) / (seconds - lastSampleSeconds) : 0.0;
+            stats.bestFitness = currentBestFitness;
+            ga->fitnessStatistics(stats.meanFitness, stats.stddevFitness);
+            stats.diversity = diversity;
+            stats.populationSize = decision.populationSize;
+            stats.mutationProbability = decision.mutationProbability;
+            long long lookups = hits - lastSampleHits + misses - lastSampleMisses;
+            stats.cacheHitRate = lookups > 0 ? (double) (hits - lastSampleHits) / (double) lookups : 0.0;
+            telemetry.record(stats);
+            lastSampleSeconds = seconds;
+            lastSampleEvaluations = evaluated;
+            lastSampleHits = hits;
+            lastSampleMisses = misses;
+        }
+        if (currentBestFitness >= GRID_SIDE * GRID_SIDE * GRID_SIDE) break;
+
+        GenerationReport report{generation, currentBestFitness, currentBestFitness > bestFitness, diversity};
+        bestFitness = max(bestFitness, currentBestFitness);
+        float mutationProbability = decision.mutationProbability;
+        controller->observe(report, decision);
+        if (decision.mutationProbability != mutationProbability) {
+            ga->setMutationProbability(decision.mutationProbability);
+        }
+        if (decision.restart) {
+            ga->setPopulationSize(decision.populationSize);
+            ga->restart(decision.restartKeepFraction);
+            decision.restart = false;
+            diversity = 1.0;
+            restarts++;
         }
-        return 1;
-    } else {
-        return 0;
-    }
-}
-
-bool backtrackRemoveNumbers(GA1DArrayGenome<int> &genome) {
-    genomeToGrid(genome);
-    if(countZeros(grid) > 55) return true;
-    for (int i = 0; i < N * N; ++i) {
-        if (genome.gene(i) != 0) {
-            int originalValue = genome.gene(i);
-            genome.gene(i, 0);
-            genomeToGrid(genome);
 
-            if (solveSudoku(grid)) {
-                if (backtrackRemoveNumbers(genome)) {
-                    // If the remaining sudoku is solvable, we found a solution
-                    return true;
-                }
+        if (checkpoints.due()) {
+            CheckpointWriter out("generate");
+            saveBatch(out, seed, batch, telemetry.flushedSize());
+            out.put(generation);
+            out.put(decision.populationSize);
+            out.put(decision.mutationProbability);
+            out.put(decision.maxGenerations);
+            out.put(bestFitness);
+            out.put(diversity);
+            out.put(restarts);
+            out.put(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+            // A snapshot without the complete state could not be resumed exactly, so none is written
+            if (controller->saveState(out) && ga->saveState(out)) {
+                out.commit(checkpoints.path());
+            } else {
+                cerr << "Cannot save the state of the " << config.engine << " engine, checkpoint skipped" << endl;
             }
-
-            // Revert the change
-            genome.gene(i, originalValue);
         }
     }
-    return false;  // No solution found
-}
-
-void removeNumbers(GA1DArrayGenome<int> &bestGenome) {
-    GA1DArrayGenome<int> bestGenomeCopy = bestGenome;
-    genomeToGrid(bestGenomeCopy);
-    if (backtrackRemoveNumbers(bestGenomeCopy)) {
-        // If backtracking was successful, update the original bestGenome
-        bestGenome = bestGenomeCopy;
-    }
-}
 
-int main() {
-    srand(static_cast<unsigned int>(time(nullptr)));
-
-    GA1DArrayGenome<int> genome(N * N, objective);
-    genome.initializer(initializer);
-    genome.mutator(mutator);
-    genome.crossover(crossover);
-
-    GASimpleGA ga(genome);
-    ga.initialize();
-    ga.pMutation(MUTATION_PROBABILITY);
-    ga.pCrossover(CROSSOVER_PROBABILITY);
-
-    int populationSize = POPULATION_SIZE;
-    int maxGenerations = MAX_GENERATIONS;
-    int generationsWithoutImprovement = 0;
-    float bestFitness = 0.0;
+    // Time to solution, so that the control policies can be compared
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Control " << config.control << ": " << generation << " generations, " << seconds << " s";
+    if (restarts > 0) cout << ", " << restarts << " restarts";
+    cout << (ga->bestFitness() >= GRID_SIDE * GRID_SIDE * GRID_SIDE ? ", solved" : ", not solved") << endl;
 
-    for (int generation = 0; generation < maxGenerations; ++generation) {
-        // Update population size and generations based on the generation number
-        ga.populationSize(populationSize);
-        ga.nGenerations(maxGenerations - generation);
-
-        // Evolve for the current generation
-        ga.step();
+    uint8_t board[GENOME_LENGTH];
+    ga->bestBoard(board);
+    unpackGenome(board, result);
+    return true;
+}
 
-        auto &bestGenome = (GA1DArrayGenome<int> &) ga.statistics().bestIndividual();
-        float currentBestFitness = objective((GAGenome &) bestGenome);
+int main(int argc, char **argv) {
+    GAConfig config;
+    if (!parseArguments(argc, argv, config)) return 1;
 
-        cout << "Generation " << generation + 1 << ": Fitness = " << currentBestFitness << endl;
+    if (!config.seedGridsPath.empty()) {
+        if (!seedGrids.load(config.seedGridsPath)) return 1;
+        seedFraction = config.seedFraction;
+    }
 
-        if (currentBestFitness > bestFitness) {
-            generationsWithoutImprovement = 0;
-            bestFitness = currentBestFitness;
-        } else {
-            generationsWithoutImprovement++;
+    applySolverConfig(config.solver);
+    ConstraintTable variant(config.variant);
+    if (config.variant != "classic") activeVariant = &variant;
+
+    unsigned int seed = config.seed ? (unsigned int) config.seed : static_cast<unsigned int>(time(nullptr));
+    CheckpointSettings checkpoint;
+    checkpoint.path = config.checkpointPath;
+    checkpoint.interval = config.checkpointInterval;
+    checkpoint.resume = config.resume;
+
+    // A resumed batch continues with the seed it was started with
+    BatchState batch;
+    CheckpointReader resumeFrom;
+    long long telemetryBytes = -1;
+    if (config.resume) {
+        if (!resumeFrom.open(config.checkpointPath, "generate") ||
+            !loadBatch(resumeFrom, seed, batch, telemetryBytes)) return 1;
+    }
+    Telemetry telemetry;
+    if (!config.telemetryPath.empty() &&
+        !telemetry.open(config.telemetryPath, config.telemetryInterval, telemetryBytes)) return 1;
+    seedRandom(seed);
+
+    unique_ptr<ParallelRemover> remover;
+    if (config.removal != "backtrack" || config.verifyMinimal) remover.reset(new ParallelRemover(config.threads));
+
+    CheckpointTimer checkpoints(checkpoint);
+    CheckpointReader *resuming = config.resume ? &resumeFrom : nullptr;
+    for (; batch.run < config.puzzleCount; ++batch.run) {
+        // Output the best Sudoku board
+        GA1DArrayGenome<int> bestGenome(GRID_SIDE * GRID_SIDE, objective);
+        if (!evolveGrid(bestGenome, config, telemetry, seed, batch, checkpoints, resuming)) return 1;
+        resuming = nullptr;
+        cout << "Best solution found: " << endl;
+        cout << "Fitness: " << objective((GAGenome &) bestGenome) << endl;
+        genomeToGrid(bestGenome);
+        sudokuGrid(grid);
+        if (activeVariant && activeVariant->hasCages()) {
+            // Drawn from the seed and the run, so a resumed batch gets the same cages
+            uint8_t solution[GRID_SIDE * GRID_SIDE];
+            packGrid(grid, solution);
+            mt19937 cageRng(seed + (unsigned int) batch.run);
+            activeVariant->setRandomCages(solution, cageRng);
         }
-        // If fitness hasn't improved for the last 200 generations
-        if (generationsWithoutImprovement > 200) {
-            generationsWithoutImprovement = 0;
-            maxGenerations = maxGenerations - 50;
-
-            // reduce population size
-            populationSize = max(1000, populationSize - 10); // Minimum population size is 1000
 
-            // increase mutation probability
-            if (MUTATION_PROBABILITY < 0.2) {
-                MUTATION_PROBABILITY += 0.01;
-                ga.pMutation(MUTATION_PROBABILITY);
+        if (isSolvable(grid)) {
+            if (config.removal == "backtrack") removeNumbers(bestGenome);
+            else removeNumbersParallel(bestGenome, *remover, config.removal == "minimal");
+            genomeToGrid(bestGenome);
+            if (!batch.puzzles.insert(grid)) {
+                cout << "Duplicate puzzle dropped" << endl;
+                batch.duplicates++;
+                continue;
             }
+            sudokuGrid(grid);
+            if (activeVariant && activeVariant->hasCages()) cout << "Cages: " << activeVariant->describeCages() << endl;
+            if (config.verifyMinimal) {
+                cout << GRID_SIDE * GRID_SIDE - countZeros(grid) << " clues, "
+                     << (isMinimalPuzzle(bestGenome, *remover) ? "minimal" : "not minimal") << endl;
+            }
+            isSolvable(grid);
         }
-        if (currentBestFitness >= N * N * N) break;
     }
-
-    // Output the best Sudoku board
-    auto &bestGenome = (GA1DArrayGenome<int> &) ga.statistics().bestIndividual();
-    cout << "Best solution found: " << endl;
-    cout << "Fitness: " << objective((GAGenome &) bestGenome) << endl;
-    genomeToGrid(bestGenome);
-    sudokuGrid(grid);
-
-    if (isSolvable(grid)) {
-        removeNumbers(bestGenome);
-        genomeToGrid(bestGenome);
-        sudokuGrid(grid);
-        isSolvable(grid);
+    if (config.puzzleCount > 1) {
+        cout << batch.puzzles.size() << " unique puzzles generated, " << batch.duplicates << " duplicates dropped" << endl;
     }
-
-    // free the allocated memory
-    for (int i = 0; i < N; ++i) {
-        delete[] grid[i];
+    // The batch is complete, a later --resume must not repeat its last run
+    if (!checkpoint.path.empty()) remove(checkpoint.path.c_str());
+    if (config.solver.propagation && solverStats.calls > 0) {
+        cout << "Solver: " << solverStats.calls << " calls, " << solverStats.propagatedShare() * 100.0
+             << "% of the cells filled by propagation, " << solverStats.guesses << " guesses, "
+             << solverStats.budgetExhaustions << " budget exhaustions" << endl;
     }
-    delete[] grid;
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include "sudoku_checkpoint.cpp"
+
+using namespace std;
+
+// Adaptive parameter control of the generation loop. After every generation the loop reports what
+// it measured and the controller answers with the parameters of the next generation.
+
+// Measurements of one generation
+struct GenerationReport {
+    int generation;
+    float bestFitness;
+    bool improved; // the best fitness went up in this generation
+    float diversity; // last measured population diversity, see populationDiversity
+};
+
+// Parameters of the next generation, prefilled with the current ones
+struct ControlDecision {
+    int populationSize;
+    float mutationProbability;
+    int maxGenerations; // generation budget of the run
+    bool restart; // rebuild the population, keeping restartKeepFraction of the best individuals
+    float restartKeepFraction;
+};
+
+// Settings shared by the policies
+struct ControlSettings {
+    int initialPopulationSize = 20000;
+    float initialMutationProbability = 0.05;
+    int stallGenerations = 200;
+    int generationDecrement = 50;
+    int populationDecrement = 10;
+    int minPopulationSize = 1000;
+    int maxPopulationSize = 40000;
+    float mutationIncrement = 0.01;
+    float maxMutationProbability = 0.2;
+    float minDiversity = 0.02; // restart policy: restart as soon as diversity falls below this
+    float restartKeepFraction = 0.1;
+};
+
+class AdaptiveController {
+public:
+    explicit AdaptiveController(const ControlSettings &controlSettings) : settings(controlSettings) {}
+
+    virtual ~AdaptiveController() {}
+
+    virtual void observe(const GenerationReport &report, ControlDecision &decision) = 0;
+
+    // What a checkpoint has to restore, the settings come from the configuration
+    bool saveState(CheckpointWriter &out) const {
+        out.put(stallCount);
+        return true;
+    }
+
+    bool loadState(CheckpointReader &in) {
+        return in.get(stallCount);
+    }
+
+protected:
+    // Counts generations without improvement, returns true when the stall window is exceeded
+    bool stalled(const GenerationReport &report) {
+        stallCount = report.improved ? 0 : stallCount + 1;
+        if (stallCount <= settings.stallGenerations) return false;
+        stallCount = 0;
+        return true;
+    }
+
+    ControlSettings settings;
+    int stallCount = 0;
+};
+
+// The original fixed schedule: on every stall cut the generation budget and the population and
+// raise the mutation probability up to its cap
+class StallScheduleController : public AdaptiveController {
+public:
+    using AdaptiveController::AdaptiveController;
+
+    void observe(const GenerationReport &report, ControlDecision &decision) override {
+        if (!stalled(report)) return;
+        decision.maxGenerations -= settings.generationDecrement;
+        decision.populationSize = max(settings.minPopulationSize, decision.populationSize - settings.populationDecrement);
+        if (decision.mutationProbability < settings.maxMutationProbability) {
+            decision.mutationProbability += settings.mutationIncrement;
+        }
+    }
+};
+
+// Restart on stall, or on lost diversity once the search has not improved for a quarter of the stall
+// window: the population is rebuilt around its best individuals and the mutation probability starts
+// over, the generation budget is left alone
+class RestartController : public AdaptiveController {
+public:
+    using AdaptiveController::AdaptiveController;
+
+    void observe(const GenerationReport &report, ControlDecision &decision) override {
+        bool stall = stalled(report);
+        bool converged = report.diversity < settings.minDiversity && stallCount >= settings.stallGenerations / 4;
+        if (!stall && !converged) return;
+        decision.restart = true;
+        decision.restartKeepFraction = settings.restartKeepFraction;
+        decision.mutationProbability = settings.initialMutationProbability;
+        stallCount = 0;
+    }
+};
+
+// The 1/5th success rule for mutation rates: raise the rate by a factor F after a generation that
+// improved the best fitness and lower it by F^(1/4) otherwise, which settles where one generation
+// in five is a success
+class OneFifthController : public AdaptiveController {
+public:
+    using AdaptiveController::AdaptiveController;
+
+    void observe(const GenerationReport &report, ControlDecision &decision) override {
+        const float factor = 1.5f;
+        float p = report.improved ? decision.mutationProbability * factor
+                                  : decision.mutationProbability / pow(factor, 0.25f);
+        decision.mutationProbability = min(settings.maxMutationProbability, max(0.001f, p));
+        if (stalled(report)) decision.maxGenerations -= settings.generationDecrement;
+    }
+};
+
+// Population resizing: grow the population by half on a stall (the engine keeps every individual
+// and adds fresh ones), shrink it back by a tenth while the search keeps improving and is diverse
+class ResizeController : public AdaptiveController {
+public:
+    using AdaptiveController::AdaptiveController;
+
+    void observe(const GenerationReport &report, ControlDecision &decision) override {
+        if (stalled(report)) {
+            decision.populationSize = min(settings.maxPopulationSize, decision.populationSize * 3 / 2);
+            decision.maxGenerations -= settings.generationDecrement;
+        } else if (report.improved && report.diversity >= settings.minDiversity) {
+            decision.populationSize = max(settings.minPopulationSize, decision.populationSize * 9 / 10);
+        }
+    }
+};
+
+const char *const CONTROL_POLICIES = "stall, restart, one-fifth or resize";
+
+bool isControlPolicy(const string &name) {
+    return name == "stall" || name == "restart" || name == "one-fifth" || name == "resize";
+}
+
+unique_ptr<AdaptiveController> createController(const string &policy, const ControlSettings &settings) {
+    if (policy == "restart") return unique_ptr<AdaptiveController>(new RestartController(settings));
+    if (policy == "one-fifth") return unique_ptr<AdaptiveController>(new OneFifthController(settings));
+    if (policy == "resize") return unique_ptr<AdaptiveController>(new ResizeController(settings));
+    return unique_ptr<AdaptiveController>(new StallScheduleController(settings));
+}
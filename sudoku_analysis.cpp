@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "sudoku_removal.cpp"
+
+using namespace std;
+
+// Analysis of clue sets: for every clue, the number of solutions of the puzzle without it, printed
+// as a heatmap. Clues with 1 can be removed, the higher the count the more the clue is load bearing.
+
+struct AnalysisSettings {
+    string inputPath; // puzzles, one line of 81 digits each, 0 or . for empty cells
+    int solutionCap = 100;
+    int threads = 0;
+};
+
+bool readPuzzles(const string &path, vector<array<uint8_t, KERNEL_CELLS>> &puzzles) {
+    ifstream in(path);
+    if (!in) {
+        cerr << "Cannot open puzzle file " << path << endl;
+        return false;
+    }
+    string line;
+    int lineNumber = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        array<uint8_t, KERNEL_CELLS> puzzle{};
+        bool valid = line.size() == KERNEL_CELLS;
+        for (int cell = 0; valid && cell < KERNEL_CELLS; ++cell) {
+            char c = line[cell];
+            valid = c == '.' || (c >= '0' && c <= '9');
+            puzzle[cell] = (uint8_t) (c == '.' ? 0 : c - '0');
+        }
+        if (!valid) {
+            cerr << path << ":" << lineNumber << ": expected 81 digits" << endl;
+            return false;
+        }
+        puzzles.push_back(puzzle);
+    }
+    return true;
+}
+
+// Heatmap of the removal solution counts: . for empty cells, ? when the budget ran out and the cap
+// followed by + when it was reached
+void printRemovalHeatmap(const vector<int> &counts, int cap) {
+    for (int row = 0; row < KERNEL_SIDE; row++) {
+        for (int col = 0; col < KERNEL_SIDE; col++) {
+            if (col == 3 || col == 6) cout << " |";
+            int count = counts[row * KERNEL_SIDE + col];
+            string text = count == 0 ? "." : count < 0 ? "?" : to_string(count) + (count >= cap ? "+" : "");
+            cout << setw(5) << text;
+        }
+        cout << endl;
+        if (row == 2 || row == 5) cout << string(5 * KERNEL_SIDE + 4, '-') << endl;
+    }
+}
+
+// Analyze every puzzle of the input file, returns false if it cannot be read
+bool runAnalysis(const AnalysisSettings &settings) {
+    vector<array<uint8_t, KERNEL_CELLS>> puzzles;
+    if (!readPuzzles(settings.inputPath, puzzles)) return false;
+    ParallelRemover remover(settings.threads);
+    vector<int> counts;
+    for (const array<uint8_t, KERNEL_CELLS> &puzzle: puzzles) {
+        remover.removalSolutionCounts(puzzle.data(), settings.solutionCap, counts);
+        int clues = 0, removable = 0, unknown = 0;
+        for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+            if (puzzle[cell] != 0) clues++;
+            if (counts[cell] == 1) removable++;
+            if (counts[cell] < 0) unknown++;
+        }
+        for (uint8_t digit: puzzle) {
+            cout << (int) digit;
+        }
+        cout << endl << clues << " clues, " << removable << " removable";
+        if (unknown > 0) cout << ", " << unknown << " over budget";
+        cout << endl;
+        printRemovalHeatmap(counts, settings.solutionCap);
+        cout << endl;
+    }
+    return true;
+}
@@ -0,0 +1,47 @@
+#include <string>
+#include <vector>
+#include "sudoku_analysis.cpp"
+#include "sudoku_options.cpp"
+
+using namespace std;
+
+// The clue analysis (see sudoku_analysis.cpp) as a program of its own, built on sudoku_core without
+// GAlib
+
+struct AnalysisConfig {
+    string inputPath; // puzzles, one line of 81 digits each
+    int solutionCap = 100;
+    int threads = 0; // 0 = one per hardware thread
+    SolverConfig solver;
+};
+
+vector<ConfigOption> configOptions(AnalysisConfig &config) {
+    vector<ConfigOption> options = {
+            {"input",        CONFIG_TEXT, &config.inputPath,   "puzzle file, one line of 81 digits each"},
+            {"solution-cap", CONFIG_INT,  &config.solutionCap, "solutions counted per removed clue"},
+            {"threads",      CONFIG_INT,  &config.threads,     "worker threads, 0 = one per hardware thread"},
+    };
+    addSolverOptions(options, config.solver);
+    return options;
+}
+
+bool validateConfig(const AnalysisConfig &config) {
+    vector<string> errors;
+    if (config.inputPath.empty()) errors.push_back("input file missing");
+    if (config.solutionCap < 2) errors.push_back("solution-cap must be at least 2");
+    if (config.threads < 0) errors.push_back("threads must not be negative");
+    validateSolverConfig(config.solver, errors);
+    return reportConfigErrors(errors);
+}
+
+int main(int argc, char **argv) {
+    AnalysisConfig config;
+    if (!parseArguments(argc, argv, config)) return 1;
+
+    applySolverConfig(config.solver);
+    AnalysisSettings settings;
+    settings.inputPath = config.inputPath;
+    settings.solutionCap = config.solutionCap;
+    settings.threads = config.threads;
+    return runAnalysis(settings) ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+#include <ga/GA1DArrayGenome.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "sudoku_ga.cpp"
+#include "sudoku_hint.cpp"
+
+using namespace std;
+
+// Benchmarks of the solver, fitness and generator hot paths.
+// Usage: sudoku_benchmark [--json] [--min-time SECONDS] [--filter SUBSTRING]
+
+const unsigned int BENCHMARK_SEED = 12345;
+
+// Fixed puzzle sets, one puzzle per line in row-major order, 0 marks an empty cell
+const vector<string> EASY_PUZZLES = {
+        "530070000600195000098000060800060003400803001700020006060000280000419005000080079",
+        "003020600900305001001806400008102900700000008006708200002609500800203009005010300",
+};
+const vector<string> HARD_PUZZLES = {
+        "800000000003600000070090200050007000000045700000100030001000068008500010090000400",
+        "100007090030020008009600500005300900010080002600004000300000010040000007007000300",
+};
+const vector<string> CLUE17_PUZZLES = {
+        "000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+        "000000012000035000000600070700000300000400800100000000000120000080000040050000600",
+        "400000805030000000000700000020000060000080400000010000000603070500200000104000000",
+};
+// Designed against row-major brute force: the first row of the solution is 987654321
+const vector<string> ANTI_BACKTRACKER_PUZZLES = {
+        "000000000000003085001020000000507000004000100090000000500000073002010000000040009",
+};
+const string SOLVED_GRID = "534678912672195348198342567859761423426853791713924856961537284287419635345286179";
+
+struct BenchmarkResult {
+    string name;
+    long long iterations;
+    double nsPerOp;
+};
+
+double minSeconds = 0.5;
+string filter;
+vector<BenchmarkResult> results;
+
+int **parseGrid(const string &cells) {
+    int **board = new int *[GRID_SIDE];
+    for (int i = 0; i < GRID_SIDE; ++i) {
+        board[i] = new int[GRID_SIDE];
+        for (int j = 0; j < GRID_SIDE; ++j) {
+            board[i][j] = cells[i * GRID_SIDE + j] - '0';
+        }
+    }
+    return board;
+}
+
+void freeGrid(int **board) {
+    for (int i = 0; i < GRID_SIDE; ++i) {
+        delete[] board[i];
+    }
+    delete[] board;
+}
+
+void copyGrid(int **from, int **to) {
+    for (int i = 0; i < GRID_SIDE; ++i) {
+        memcpy(to[i], from[i], GRID_SIDE * sizeof(int));
+    }
+}
+
+void gridToGenome(int **board, GA1DArrayGenome<int> &genome) {
+    for (int i = 0; i < GRID_SIDE; ++i) {
+        for (int j = 0; j < GRID_SIDE; ++j) {
+            genome.gene(i * GRID_SIDE + j, board[i][j]);
+        }
+    }
+}
+
+// Keeps the compiler from discarding the results of benchmarked calls
+volatile long long sink;
+
+// Run op with increasing batch sizes until it ran for at least minSeconds, op gets the iteration index
+void runBenchmark(const string &name, const function<void(long long)> &op) {
+    if (!filter.empty() && name.find(filter) == string::npos) return;
+    seedRandom(BENCHMARK_SEED);
+    op(0); // warm up
+
+    long long iterations = 0;
+    long long batch = 1;
+    double elapsed = 0.0;
+    auto start = chrono::steady_clock::now();
+    while (elapsed < minSeconds) {
+        for (long long i = 0; i < batch; ++i) {
+            op(iterations + i);
+        }
+        iterations += batch;
+        batch *= 2;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    results.push_back({name, iterations, elapsed * 1e9 / (double) iterations});
+}
+
+void benchmarkSolver(const string &set, const vector<string> &puzzles) {
+    vector<int **> boards;
+    for (const string &puzzle: puzzles) {
+        boards.push_back(parseGrid(puzzle));
+    }
+    int **board = parseGrid(puzzles[0]);
+    // Singles only (the default), with locked candidates, and the plain recursion
+    const char *variants[] = {"", "/locked", "/recursion"};
+    for (int variant = 0; variant < 3; ++variant) {
+        propagationOptions.enabled = variant != 2;
+        propagationOptions.lockedCandidates = variant == 1;
+        runBenchmark("solveSudoku/" + set + variants[variant], [&](long long i) {
+            copyGrid(boards[i % boards.size()], board);
+            sink = solveSudoku(board);
+        });
+    }
+    propagationOptions = PropagationOptions();
+    // The hint for the starting grid, the interactive latency
+    vector<vector<uint8_t>> packed;
+    for (int **b: boards) {
+        packed.emplace_back(KERNEL_CELLS);
+        packGrid(b, packed.back().data());
+    }
+    runBenchmark("findHint/" + set, [&](long long i) {
+        sink = findHint(packed[i % packed.size()].data()).cell;
+    });
+    freeGrid(board);
+    for (int **b: boards) {
+        freeGrid(b);
+    }
+}
+
+void printResults(bool json) {
+    if (json) {
+        cout << "{\"seed\": " << BENCHMARK_SEED << ", \"min_time\": " << minSeconds << ", \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchmarkResult &r = results[i];
+            cout << (i ? ", " : "") << "{\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+                 << ", \"ns_per_op\": " << fixed << setprecision(1) << r.nsPerOp
+                 << ", \"ops_per_s\": " << setprecision(1) << 1e9 / r.nsPerOp << "}";
+        }
+        cout << "]}" << endl;
+        return;
+    }
+    cout << left << setw(34) << "benchmark" << right << setw(12) << "iterations" << setw(16) << "ns/op"
+         << setw(16) << "ops/s" << endl;
+    for (const BenchmarkResult &r: results) {
+        cout << left << setw(34) << r.name << right << setw(12) << r.iterations << fixed << setprecision(1)
+             << setw(16) << r.nsPerOp << setw(16) << 1e9 / r.nsPerOp << endl;
+    }
+}
+
+int main(int argc, char **argv) {
+    bool json = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--json") {
+            json = true;
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            minSeconds = atof(argv[++i]);
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            cerr << "Usage: " << argv[0] << " [--json] [--min-time SECONDS] [--filter SUBSTRING]" << endl;
+            return 1;
+        }
+    }
+
+    benchmarkSolver("easy", EASY_PUZZLES);
+    benchmarkSolver("hard", HARD_PUZZLES);
+    benchmarkSolver("17-clue", CLUE17_PUZZLES);
+    benchmarkSolver("anti-backtracker", ANTI_BACKTRACKER_PUZZLES);
+
+    // A pool of fixed random individuals for the GA operators
+    seedRandom(BENCHMARK_SEED);
+    const int poolSize = 64;
+    vector<GA1DArrayGenome<int>> genomes(poolSize, GA1DArrayGenome<int>(GRID_SIDE * GRID_SIDE, objective));
+    for (GA1DArrayGenome<int> &genome: genomes) {
+        initializer(genome);
+    }
+    int **solved = parseGrid(SOLVED_GRID);
+    GA1DArrayGenome<int> solvedGenome(GRID_SIDE * GRID_SIDE, objective);
+    gridToGenome(solved, solvedGenome);
+
+    runBenchmark("checkSudoku/solved", [&](long long) {
+        sink = checkSudoku(solved);
+    });
+    runBenchmark("checkSudoku/random", [&](long long i) {
+        genomeToGrid(genomes[i % poolSize]);
+        sink = checkSudoku(grid);
+    });
+    runBenchmark("objective/solved", [&](long long) {
+        sink = (long long) objective(solvedGenome);
+    });
+    runBenchmark("objective/random", [&](long long i) {
+        sink = (long long) objective(genomes[i % poolSize]);
+    });
+    // The same operators on the packed population storage, streaming through 20000 individuals
+    const int populationSize = 20000;
+    Population population(populationSize), offspring(populationSize);
+    for (int i = 0; i < populationSize; ++i) {
+        initializeBoard(population.genes(i), generator);
+    }
+    runBenchmark("boardObjective/population", [&](long long i) {
+        int individual = (int) (i % populationSize);
+        population.fitness(individual) = boardObjective(population.genes(individual));
+    });
+    // Conflict counting kernels, one op scores a batch of 32 boards
+    vector<int> repetitions(populationSize);
+    for (const char *kernel: {"scalar", "ssse3", "avx2"}) {
+        if (!selectRepetitionsKernel(kernel)) continue;
+        runBenchmark(string("boardRepetitionsBatch/32/") + kernel, [&](long long i) {
+            int first = (int) (i * 32 % (populationSize - 32));
+            boardRepetitionsBatch(population.genes(first), 32, repetitions.data() + first);
+        });
+    }
+    selectRepetitionsKernel(detectKernel().name);
+    runBenchmark("evaluatePopulation/256", [&](long long i) {
+        int first = (int) (i * 256 % (populationSize - 256));
+        evaluatePopulation(population, first, first + 256);
+    });
+    runBenchmark("initializeBoard", [&](long long i) {
+        initializeBoard(offspring.genes((int) (i % populationSize)), generator);
+    });
+    runBenchmark("mutateBoard", [&](long long i) {
+        sink = mutateBoard(population.genes((int) (i % populationSize)), 1.0f, generator);
+    });
+    runBenchmark("crossoverBoards", [&](long long i) {
+        int individual = (int) (i % (populationSize - 1)) & ~1;
+        sink = crossoverBoards(population.genes(individual), population.genes(individual + 1),
+                               offspring.genes(individual), offspring.genes(individual + 1), generator);
+    });
+
+    // One generation of each engine on a population of 20000, single threaded
+    {
+        GAlibEngine galib(0.01f, 0.05f);
+        galib.setPopulationSize(populationSize);
+        galib.initialize();
+        runBenchmark("engine/galib/step", [&](long long) {
+            galib.step();
+        });
+        SteadyStateParameters parameters;
+        parameters.populationSize = populationSize;
+        parameters.threads = 1;
+        parameters.seed = BENCHMARK_SEED;
+        SteadyStateEngine steadyState(parameters);
+        steadyState.initialize();
+        runBenchmark("engine/steady-state/step", [&](long long) {
+            steadyState.step();
+        });
+    }
+
+    GA1DArrayGenome<int> child1(GRID_SIDE * GRID_SIDE, objective), child2(GRID_SIDE * GRID_SIDE, objective);
+    runBenchmark("initializer", [&](long long) {
+        initializer(child1);
+    });
+    runBenchmark("mutator", [&](long long i) {
+        sink = mutator(genomes[i % poolSize], 1.0);
+    });
+    runBenchmark("crossover", [&](long long i) {
+        sink = crossover(genomes[i % poolSize], genomes[(i + 1) % poolSize], &child1, &child2);
+    });
+    runBenchmark("removeNumbers", [&](long long) {
+        GA1DArrayGenome<int> puzzle = solvedGenome;
+        removeNumbers(puzzle);
+    });
+    ParallelRemover remover;
+    runBenchmark("removeNumbers/parallel", [&](long long) {
+        GA1DArrayGenome<int> puzzle = solvedGenome;
+        removeNumbersParallel(puzzle, remover);
+    });
+    runBenchmark("removeNumbers/minimal", [&](long long) {
+        GA1DArrayGenome<int> puzzle = solvedGenome;
+        removeNumbersParallel(puzzle, remover, true);
+    });
+    GA1DArrayGenome<int> minimalPuzzle = solvedGenome;
+    removeNumbersParallel(minimalPuzzle, remover, true);
+    runBenchmark("isMinimalPuzzle", [&](long long) {
+        sink = isMinimalPuzzle(minimalPuzzle, remover);
+    });
+    freeGrid(solved);
+
+    printResults(json);
+    return 0;
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "sudoku_checkpoint.cpp"
+#include "sudoku_solver.h"
+
+using namespace std;
+
+// Canonical form of a sudoku under its symmetry group: transposition, band and stack
+// permutations, row and column permutations within bands/stacks and digit relabeling.
+// The canonical form is the lexicographically smallest row-major string (0 = empty cell)
+// among all equivalent grids, so two grids are equivalent iff their canonical forms are equal.
+
+// All 1296 orders of the 9 lines (rows or columns) that keep bands together:
+// 6 band orders times 6 line orders inside each of the 3 bands.
+vector<array<int, GRID_SIDE>> buildLineOrders() {
+    vector<array<int, GRID_SIDE>> orders;
+    int perm[3] = {0, 1, 2};
+    vector<array<int, 3>> perms;
+    do {
+        perms.push_back({perm[0], perm[1], perm[2]});
+    } while (next_permutation(perm, perm + 3));
+    for (auto &bands: perms)
+        for (auto &first: perms)
+            for (auto &second: perms)
+                for (auto &third: perms) {
+                    const array<int, 3> *inner[3] = {&first, &second, &third};
+                    array<int, GRID_SIDE> order{};
+                    for (int b = 0; b < 3; ++b)
+                        for (int i = 0; i < 3; ++i)
+                            order[b * 3 + i] = bands[b] * 3 + (*inner[b])[i];
+                    orders.push_back(order);
+                }
+    return orders;
+}
+
+const vector<array<int, GRID_SIDE>> &lineOrders() {
+    static const vector<array<int, GRID_SIDE>> orders = buildLineOrders();
+    return orders;
+}
+
+// Apply a random element of the symmetry group to a packed grid (row-major, 0 = empty cell)
+void randomSymmetry(const uint8_t *from, uint8_t *to, mt19937 &rng) {
+    const vector<array<int, GRID_SIDE>> &orders = lineOrders();
+    uniform_int_distribution<int> pickOrder(0, (int) orders.size() - 1);
+    const array<int, GRID_SIDE> &rows = orders[pickOrder(rng)];
+    const array<int, GRID_SIDE> &columns = orders[pickOrder(rng)];
+    bool transposed = rng() & 1;
+    uint8_t relabel[GRID_SIDE + 1];
+    for (int digit = 0; digit <= GRID_SIDE; ++digit) {
+        relabel[digit] = (uint8_t) digit;
+    }
+    shuffle(relabel + 1, relabel + GRID_SIDE + 1, rng);
+    for (int row = 0; row < GRID_SIDE; ++row) {
+        for (int col = 0; col < GRID_SIDE; ++col) {
+            int r = rows[row], c = columns[col];
+            to[row * GRID_SIDE + col] = relabel[transposed ? from[c * GRID_SIDE + r] : from[r * GRID_SIDE + c]];
+        }
+    }
+}
+
+// A partial transformation: the source rows placed so far, the column order and the digit relabeling
+struct CanonicalCandidate {
+    uint8_t transposed;
+    uint8_t rows[GRID_SIDE];
+    uint16_t columns;
+    uint8_t relabel[GRID_SIDE + 1];
+    uint8_t nextLabel;
+};
+
+// Candidates kept per level. Puzzles keep at most a few thousand, but on boards with only a
+// handful of clues nearly every transformation ties and the full set would reach millions.
+const size_t CANONICAL_CANDIDATE_CAP = 1 << 16;
+
+// The canonical form is built one output row at a time. Every level extends the surviving
+// candidates by each admissible source row and keeps only those that produce the smallest
+// row so far, which prunes the 3.3 million transformations down to a few thousand row evaluations.
+// Ties beyond CANONICAL_CANDIDATE_CAP are dropped. The result is still a transformation of the
+// board, so boards that are not equivalent never share a form, but two equivalent boards that
+// sparse may get different forms.
+string canonicalForm(const uint8_t *board) {
+    const vector<array<int, GRID_SIDE>> &orders = lineOrders();
+    uint8_t source[2][GRID_SIDE][GRID_SIDE];
+    for (int row = 0; row < GRID_SIDE; ++row) {
+        for (int col = 0; col < GRID_SIDE; ++col) {
+            source[0][row][col] = board[row * GRID_SIDE + col];
+            source[1][col][row] = board[row * GRID_SIDE + col];
+        }
+    }
+
+    thread_local vector<CanonicalCandidate> current, next;
+    current.clear();
+    for (int t = 0; t < 2; ++t) {
+        for (int c = 0; c < (int) orders.size(); ++c) {
+            CanonicalCandidate candidate{};
+            candidate.transposed = (uint8_t) t;
+            candidate.columns = (uint16_t) c;
+            candidate.nextLabel = 1;
+            current.push_back(candidate);
+        }
+    }
+
+    string result(GRID_SIDE * GRID_SIDE, '0');
+    for (int level = 0; level < GRID_SIDE; ++level) {
+        uint8_t best[GRID_SIDE];
+        bool haveBest = false;
+        next.clear();
+        for (const CanonicalCandidate &candidate: current) {
+            // Rows that may come next: a fresh band at the start of each band, else the rest of the current band
+            int choices[GRID_SIDE];
+            int nChoices = 0;
+            for (int row = 0; row < GRID_SIDE; ++row) {
+                bool used = false;
+                for (int i = 0; i < level; ++i)
+                    if (candidate.rows[i] == row) used = true;
+                if (used) continue;
+                if (level % 3 != 0 && row / 3 != candidate.rows[level - level % 3] / 3) continue;
+                choices[nChoices++] = row;
+            }
+            const array<int, GRID_SIDE> &columns = orders[candidate.columns];
+            for (int k = 0; k < nChoices; ++k) {
+                CanonicalCandidate extended = candidate;
+                extended.rows[level] = (uint8_t) choices[k];
+                const uint8_t *line = source[candidate.transposed][choices[k]];
+                uint8_t out[GRID_SIDE];
+                int cmp = haveBest ? 0 : -1;
+                for (int j = 0; j < GRID_SIDE; ++j) {
+                    uint8_t value = line[columns[j]];
+                    if (value != 0) {
+                        if (extended.relabel[value] == 0) extended.relabel[value] = extended.nextLabel++;
+                        value = extended.relabel[value];
+                    }
+                    out[j] = value;
+                    if (cmp == 0 && out[j] != best[j]) {
+                        cmp = out[j] < best[j] ? -1 : 1;
+                        if (cmp > 0) break;
+                    }
+                }
+                if (cmp > 0) continue;
+                if (cmp < 0) {
+                    copy(out, out + GRID_SIDE, best);
+                    haveBest = true;
+                    next.clear();
+                }
+                if (next.size() < CANONICAL_CANDIDATE_CAP) next.push_back(extended);
+            }
+        }
+        for (int j = 0; j < GRID_SIDE; ++j) result[level * GRID_SIDE + j] = (char) ('0' + best[j]);
+        swap(current, next);
+    }
+    return result;
+}
+
+string canonicalForm(int **grid) {
+    uint8_t board[GRID_SIDE * GRID_SIDE];
+    packGrid(grid, board);
+    return canonicalForm(board);
+}
+
+// Set of canonical forms, used to drop puzzles that are equivalent to one generated before
+class PuzzleSet {
+public:
+    // Returns false if an equivalent puzzle is already in the set. The symmetries of the classic grid
+    // do not keep the extra units of a variant, so variant puzzles are only equal as they are, a
+    // Killer puzzle together with its cages.
+    bool insert(int **grid) {
+        if (!activeVariant) return forms.insert(canonicalForm(grid)).second;
+        uint8_t board[KERNEL_CELLS];
+        packGrid(grid, board);
+        return insert(board);
+    }
+
+    bool insert(const uint8_t *board) {
+        if (!activeVariant) return forms.insert(canonicalForm(board)).second;
+        return forms.insert(string((const char *) board, KERNEL_CELLS) + activeVariant->describeCages()).second;
+    }
+
+    size_t size() const {
+        return forms.size();
+    }
+
+    void saveState(CheckpointWriter &out) const {
+        out.put((uint32_t) forms.size());
+        for (const string &form: forms) {
+            out.put(form);
+        }
+    }
+
+    bool loadState(CheckpointReader &in) {
+        uint32_t count = 0;
+        in.get(count);
+        forms.clear();
+        string form;
+        for (uint32_t i = 0; i < count && in.get(form); ++i) {
+            forms.insert(form);
+        }
+        return in.good();
+    }
+
+private:
+    unordered_set<string> forms;
+};
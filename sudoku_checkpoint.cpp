@@ -0,0 +1,195 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// Checkpoints of long runs: the complete state of a GA run or a low-clue search in a compact binary
+// snapshot, written every interval so a killed process can resume where the last snapshot was taken.
+// A snapshot is the magic, the mode it belongs to and the fields in the order the writer put them;
+// values are stored in native byte order, random engines as their state words.
+
+const char CHECKPOINT_MAGIC[8] = {'S', 'D', 'K', 'C', 'K', 'P', '0', '2'};
+
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(const string &mode) {
+        data.append(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+        put(mode);
+    }
+
+    template<typename T>
+    void put(const T &value) {
+        static_assert(is_trivially_copyable<T>::value, "put copies the bytes of the value");
+        data.append((const char *) &value, sizeof(T));
+    }
+
+    void put(const string &text) {
+        put((uint32_t) text.size());
+        data.append(text);
+    }
+
+    void putBytes(const void *bytes, size_t size) {
+        data.append((const char *) bytes, size);
+    }
+
+    void putEngine(const mt19937 &engine) {
+        ostringstream text;
+        text << engine;
+        istringstream words(text.str());
+        vector<uint32_t> state{istream_iterator<uint32_t>(words), istream_iterator<uint32_t>()};
+        put((uint32_t) state.size());
+        putBytes(state.data(), state.size() * sizeof(uint32_t));
+    }
+
+    // Write the snapshot next to path and rename it over path, so a crash while writing leaves the
+    // previous snapshot intact
+    bool commit(const string &path) const {
+        string temporary = path + ".tmp";
+        {
+            ofstream out(temporary, ios::binary | ios::trunc);
+            out.write(data.data(), (streamsize) data.size());
+            if (!out.flush()) {
+                cerr << "Cannot write checkpoint " << temporary << endl;
+                return false;
+            }
+        }
+        if (rename(temporary.c_str(), path.c_str()) != 0) {
+            cerr << "Cannot replace checkpoint " << path << endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    string data;
+};
+
+// Reads a snapshot back in the order it was written. A read past the end or a malformed value makes
+// every further read fail, so callers check ok() once after reading everything.
+class CheckpointReader {
+public:
+    // Returns false if the file cannot be read or belongs to another mode
+    bool open(const string &path, const string &mode) {
+        ifstream in(path, ios::binary);
+        if (!in) {
+            cerr << "Cannot open checkpoint " << path << endl;
+            return false;
+        }
+        data.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        valid = data.size() >= sizeof(CHECKPOINT_MAGIC) &&
+                memcmp(data.data(), CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) == 0;
+        position = sizeof(CHECKPOINT_MAGIC);
+        string written;
+        if (!valid || !get(written)) {
+            cerr << "Not a checkpoint: " << path << endl;
+            return false;
+        }
+        if (written != mode) {
+            cerr << "Checkpoint " << path << " is from mode " << written << ", not " << mode << endl;
+            return false;
+        }
+        return true;
+    }
+
+    template<typename T>
+    bool get(T &value) {
+        static_assert(is_trivially_copyable<T>::value, "get copies the bytes of the value");
+        return getBytes(&value, sizeof(T));
+    }
+
+    bool get(string &text) {
+        uint32_t size = 0;
+        if (!get(size) || !available(size)) return false;
+        text.assign(data, position, size);
+        position += size;
+        return true;
+    }
+
+    bool getBytes(void *bytes, size_t size) {
+        if (!available(size)) return false;
+        memcpy(bytes, data.data() + position, size);
+        position += size;
+        return true;
+    }
+
+    bool getEngine(mt19937 &engine) {
+        uint32_t size = 0;
+        if (!get(size) || !available((size_t) size * sizeof(uint32_t))) return false;
+        vector<uint32_t> state(size);
+        getBytes(state.data(), state.size() * sizeof(uint32_t));
+        ostringstream text;
+        for (uint32_t word: state) {
+            text << word << ' ';
+        }
+        istringstream in(text.str());
+        in >> engine;
+        if (!in) valid = false;
+        return valid;
+    }
+
+    // All reads so far succeeded
+    bool good() const {
+        return valid;
+    }
+
+    size_t remaining() const {
+        return data.size() - position;
+    }
+
+    // All reads succeeded and the whole snapshot was consumed
+    bool ok() const {
+        return valid && position == data.size();
+    }
+
+private:
+    bool available(size_t size) {
+        if (valid && data.size() - position < size) valid = false;
+        return valid;
+    }
+
+    string data;
+    size_t position = 0;
+    bool valid = false;
+};
+
+// Where and how often snapshots are written, and whether the run starts from one
+struct CheckpointSettings {
+    string path; // empty = no checkpoints
+    double interval = 300.0; // seconds between two snapshots
+    bool resume = false;
+};
+
+// Tells the run loops when the next snapshot is due
+class CheckpointTimer {
+public:
+    explicit CheckpointTimer(const CheckpointSettings &settings)
+            : settings(settings), last(chrono::steady_clock::now()) {}
+
+    bool due() {
+        if (settings.path.empty()) return false;
+        auto now = chrono::steady_clock::now();
+        if (chrono::duration<double>(now - last).count() < settings.interval) return false;
+        last = now;
+        return true;
+    }
+
+    const string &path() const {
+        return settings.path;
+    }
+
+private:
+    CheckpointSettings settings;
+    chrono::steady_clock::time_point last;
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "sudoku_adaptive.cpp"
+#include "sudoku_options.cpp"
+#include "sudoku_variant.h"
+
+using namespace std;
+
+// Run-time parameters of the GA, set by command line flags and an optional config file (see
+// sudoku_options.cpp). The low-clue search, the analysis and the daemon are separate programs with
+// their own options.
+struct GAConfig {
+    string variant = "classic"; // extra units or cages of the puzzles, see sudoku_variant.cpp
+    int populationSize = 20000;
+    int maxGenerations = 5000;
+    float crossoverProbability = 0.01;
+    float mutationProbability = 0.05;
+    // Adaptive control policy, see sudoku_adaptive.cpp. The default "stall" schedule: after stallGenerations
+    // generations without improvement the generation budget and the population shrink and the mutation
+    // probability grows (up to maxMutationProbability)
+    string control = "stall";
+    int stallGenerations = 200;
+    int generationDecrement = 50;
+    int populationDecrement = 10;
+    int minPopulationSize = 1000;
+    float mutationIncrement = 0.01;
+    float maxMutationProbability = 0.2;
+    int maxPopulationSize = 40000; // resize policy only
+    float minDiversity = 0.02; // restart and resize policies
+    float restartEliteFraction = 0.1; // share of the population kept by a restart
+    string seedGridsPath; // known valid grids, one line of 81 digits each
+    float seedFraction = 0.1; // share of the fresh individuals taken from the seed grids
+    SolverConfig solver;
+    // "backtrack" (removeNumbers), "parallel" (ParallelRemover, same cap) or "minimal" (ParallelRemover
+    // until no clue can be removed)
+    string removal = "backtrack";
+    bool verifyMinimal = false; // report whether every puzzle is minimal
+    string engine = "galib"; // "galib" (GASimpleGA) or "steady-state" (in-tree engine)
+    int tournamentSize = 3; // steady-state engine only
+    float replacementRate = 0.5;
+    int eliteCount = 10;
+    int threads = 0; // 0 = one per hardware thread
+    int puzzleCount = 1; // number of puzzles generated in one batch
+    string checkpointPath; // steady-state engine only, see sudoku_checkpoint.cpp
+    float checkpointInterval = 300.0; // seconds
+    bool resume = false; // continue from checkpointPath
+    int seed = 0; // 0 seeds from the current time
+    bool progress = false; // print the best fitness of every generation
+    string telemetryPath; // per-generation statistics as CSV, or JSON lines if the name ends in .jsonl
+    int telemetryInterval = 1;
+};
+
+vector<ConfigOption> configOptions(GAConfig &config) {
+    vector<ConfigOption> options = {
+            {"variant",                  CONFIG_TEXT,  &config.variant,                "puzzle variant, classic, x, windoku or killer"},
+            {"population-size",          CONFIG_INT,   &config.populationSize,         "initial population size"},
+            {"max-generations",          CONFIG_INT,   &config.maxGenerations,         "generation budget"},
+            {"crossover-probability",    CONFIG_FLOAT, &config.crossoverProbability,   "crossover probability"},
+            {"mutation-probability",     CONFIG_FLOAT, &config.mutationProbability,    "initial mutation probability"},
+            {"control",                  CONFIG_TEXT,  &config.control,                "adaptive control policy, stall, restart, one-fifth or resize"},
+            {"stall-generations",        CONFIG_INT,   &config.stallGenerations,       "generations without improvement before the schedule steps"},
+            {"generation-decrement",     CONFIG_INT,   &config.generationDecrement,    "generation budget cut per stall"},
+            {"population-decrement",     CONFIG_INT,   &config.populationDecrement,    "population cut per stall"},
+            {"min-population-size",      CONFIG_INT,   &config.minPopulationSize,      "population size floor"},
+            {"mutation-increment",       CONFIG_FLOAT, &config.mutationIncrement,      "mutation probability increase per stall"},
+            {"max-mutation-probability", CONFIG_FLOAT, &config.maxMutationProbability, "mutation probability cap"},
+            {"max-population-size",      CONFIG_INT,   &config.maxPopulationSize,      "population size cap (resize)"},
+            {"min-diversity",            CONFIG_FLOAT, &config.minDiversity,           "diversity below which the population restarts (restart, resize)"},
+            {"restart-elite-fraction",   CONFIG_FLOAT, &config.restartEliteFraction,   "share of the population kept by a restart (restart)"},
+            {"seed-grids",               CONFIG_TEXT,  &config.seedGridsPath,          "file of valid grids, random symmetries of them seed the population"},
+            {"seed-fraction",            CONFIG_FLOAT, &config.seedFraction,           "share of fresh individuals taken from the seed grids"},
+            {"removal",                  CONFIG_TEXT,  &config.removal,                "clue removal, backtrack, parallel or minimal"},
+            {"verify-minimal",           CONFIG_FLAG,  &config.verifyMinimal,          "check that no clue of a puzzle can be removed"},
+            {"engine",                   CONFIG_TEXT,  &config.engine,                 "GA implementation, galib or steady-state"},
+            {"tournament-size",          CONFIG_INT,   &config.tournamentSize,         "tournament size (steady-state)"},
+            {"replacement-rate",         CONFIG_FLOAT, &config.replacementRate,        "share of the population replaced per generation (steady-state)"},
+            {"elite-count",              CONFIG_INT,   &config.eliteCount,             "best individuals never replaced (steady-state)"},
+            {"threads",                  CONFIG_INT,   &config.threads,                "worker threads, 0 = one per hardware thread"},
+            {"puzzles",                  CONFIG_INT,   &config.puzzleCount,            "number of puzzles generated in one batch"},
+            {"checkpoint",               CONFIG_TEXT,  &config.checkpointPath,         "snapshot file of the run (steady-state)"},
+            {"checkpoint-interval",      CONFIG_FLOAT, &config.checkpointInterval,     "seconds between snapshots"},
+            {"resume",                   CONFIG_FLAG,  &config.resume,                 "continue the run saved in the checkpoint file"},
+            {"seed",                     CONFIG_INT,   &config.seed,                   "random seed, 0 seeds from the current time"},
+            {"progress",                 CONFIG_FLAG,  &config.progress,               "print the best fitness of every generation"},
+            {"telemetry",                CONFIG_TEXT,  &config.telemetryPath,          "telemetry file, CSV or JSON lines (.jsonl)"},
+            {"telemetry-interval",       CONFIG_INT,   &config.telemetryInterval,      "generations between telemetry records"},
+    };
+    addSolverOptions(options, config.solver);
+    return options;
+}
+
+bool validateConfig(const GAConfig &config) {
+    vector<string> errors;
+    if (!isVariant(config.variant)) errors.push_back(string("variant must be ") + VARIANTS);
+    if (config.variant != "classic" && !config.seedGridsPath.empty())
+        errors.push_back("seed-grids needs the classic variant, the symmetries of a seed do not keep its extra units");
+    if (config.populationSize < 2) errors.push_back("population-size must be at least 2");
+    if (config.minPopulationSize < 2 || config.minPopulationSize > config.populationSize)
+        errors.push_back("min-population-size must be between 2 and population-size");
+    if (config.maxGenerations < 1) errors.push_back("max-generations must be at least 1");
+    if (config.crossoverProbability < 0 || config.crossoverProbability > 1)
+        errors.push_back("crossover-probability must be between 0 and 1");
+    if (config.mutationProbability < 0 || config.mutationProbability > 1)
+        errors.push_back("mutation-probability must be between 0 and 1");
+    if (config.maxMutationProbability < 0 || config.maxMutationProbability > 1)
+        errors.push_back("max-mutation-probability must be between 0 and 1");
+    if (config.mutationIncrement < 0) errors.push_back("mutation-increment must not be negative");
+    if (config.stallGenerations < 1) errors.push_back("stall-generations must be at least 1");
+    if (config.generationDecrement < 0) errors.push_back("generation-decrement must not be negative");
+    if (config.populationDecrement < 0) errors.push_back("population-decrement must not be negative");
+    if (!isControlPolicy(config.control)) errors.push_back(string("control must be ") + CONTROL_POLICIES);
+    if (config.control == "resize" && config.maxPopulationSize < config.populationSize)
+        errors.push_back("max-population-size must be at least population-size");
+    if (config.minDiversity < 0 || config.minDiversity > 1) errors.push_back("min-diversity must be between 0 and 1");
+    if (config.restartEliteFraction < 0 || config.restartEliteFraction > 1)
+        errors.push_back("restart-elite-fraction must be between 0 and 1");
+    if (config.seedFraction < 0 || config.seedFraction > 1) errors.push_back("seed-fraction must be between 0 and 1");
+    if (config.removal != "backtrack" && config.removal != "parallel" && config.removal != "minimal")
+        errors.push_back("removal must be backtrack, parallel or minimal");
+    validateSolverConfig(config.solver, errors);
+    if (config.engine != "galib" && config.engine != "steady-state")
+        errors.push_back("engine must be galib or steady-state");
+    if (config.tournamentSize < 1) errors.push_back("tournament-size must be at least 1");
+    if (config.replacementRate <= 0 || config.replacementRate > 1)
+        errors.push_back("replacement-rate must be greater than 0 and at most 1");
+    if (config.eliteCount < 0 || config.eliteCount > config.minPopulationSize - 2)
+        errors.push_back("elite-count must be between 0 and min-population-size - 2");
+    if (config.threads < 0) errors.push_back("threads must not be negative");
+    if (config.puzzleCount < 1) errors.push_back("puzzles must be at least 1");
+    if (!config.checkpointPath.empty() && config.engine != "steady-state")
+        errors.push_back("checkpoint needs the steady-state engine, GAlib's random state cannot be saved");
+    if (config.checkpointInterval <= 0) errors.push_back("checkpoint-interval must be positive");
+    if (config.resume && config.checkpointPath.empty()) errors.push_back("resume needs a checkpoint file");
+    if (config.seed < 0) errors.push_back("seed must not be negative");
+    if (config.telemetryInterval < 1) errors.push_back("telemetry-interval must be at least 1");
+    return reportConfigErrors(errors);
+}
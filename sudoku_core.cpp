@@ -0,0 +1,105 @@
+#include <cstring>
+#include <string>
+#include "sudoku_core.h"
+#include "sudoku_search.h"
+
+using namespace std;
+
+static_assert(sudoku::BOARD_CELLS == KERNEL_CELLS, "the public board is the packed board of the solver");
+
+namespace sudoku {
+
+namespace {
+
+PropagationOptions propagationFor(const SolveLimits &limits) {
+    PropagationOptions options;
+    options.lockedCandidates = limits.lockedCandidates;
+    return options;
+}
+
+SolveBudget budgetFor(const SolveLimits &limits) {
+    SolveBudget budget;
+    budget.maxNodes = limits.maxNodes;
+    budget.maxSeconds = limits.maxSeconds;
+    return budget;
+}
+
+}
+
+bool parseBoard(const string &text, Board &board) {
+    if (text.size() != (size_t) BOARD_CELLS) return false;
+    for (int cell = 0; cell < BOARD_CELLS; ++cell) {
+        char c = text[cell];
+        if (c == '.') c = '0';
+        if (c < '0' || c > '9') return false;
+        board.cells[cell] = (uint8_t) (c - '0');
+    }
+    return true;
+}
+
+Solutions countSolutions(const Board &board, const SolveLimits &limits) {
+    if (!isConsistent(board)) return Solutions::NONE;
+    SolverStats stats;
+    switch (classifyBoard(board.cells, budgetFor(limits), propagationFor(limits), stats, ClassicRules())) {
+        case NO_SOLUTION:
+            return Solutions::NONE;
+        case UNIQUE_SOLUTION:
+            return Solutions::UNIQUE;
+        case MULTIPLE_SOLUTIONS:
+            return Solutions::MULTIPLE;
+        default:
+            return Solutions::UNKNOWN;
+    }
+}
+
+bool solve(const Board &board, Board &solution, const SolveLimits &limits) {
+    if (!isConsistent(board)) return false;
+    IterativeSolver solver(board.cells, 1, propagationFor(limits));
+    SolverStats stats;
+    if (!searchWithinBudget(solver, budgetFor(limits), stats) || solver.solutions() == 0) return false;
+    memcpy(solution.cells, solver.solution(), BOARD_CELLS);
+    return true;
+}
+
+bool isConsistent(const Board &board) {
+    for (int cell = 0; cell < BOARD_CELLS; ++cell) {
+        if (board.cells[cell] > KERNEL_SIDE) return false;
+    }
+    for (int unit = 0; unit < KERNEL_UNITS; ++unit) {
+        unsigned seen = 0;
+        for (uint8_t cell: unitCells.cells[unit]) {
+            unsigned bit = 1u << board.cells[cell];
+            if (seen & bit & ALL_DIGITS) return false;
+            seen |= bit;
+        }
+    }
+    return true;
+}
+
+bool isSolved(const Board &board) {
+    return memchr(board.cells, 0, BOARD_CELLS) == nullptr && isConsistent(board);
+}
+
+string formatLine(const Board &board) {
+    string text(BOARD_CELLS, '0');
+    for (int cell = 0; cell < BOARD_CELLS; ++cell) {
+        text[cell] = (char) ('0' + board.cells[cell]);
+    }
+    return text;
+}
+
+string formatGrid(const Board &board) {
+    string text;
+    for (int row = 0; row < KERNEL_SIDE; ++row) {
+        for (int col = 0; col < KERNEL_SIDE; ++col) {
+            if (col == 3 || col == 6) text += " | ";
+            text += (char) ('0' + board.cells[row * KERNEL_SIDE + col]);
+            text += ' ';
+        }
+        if (row == 2 || row == 5) text += '\n' + string(3 * KERNEL_SIDE, '-');
+        text += '\n';
+    }
+    return text;
+}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Public interface of the sudoku_core library, for programs that embed the solver without the GA.
+// The calls take their limits as arguments and ignore the settings of the generator
+// (propagationOptions, solveBudget, activeVariant), so they solve classic sudoku and are safe to
+// call from any number of threads.
+
+namespace sudoku {
+
+const int BOARD_CELLS = 81;
+
+// Cells in row-major order, digits 1-9 and 0 for empty cells
+struct Board {
+    uint8_t cells[BOARD_CELLS];
+};
+
+// Read a board from 81 characters, digits 1-9 and '0' or '.' for empty cells; false on anything else
+bool parseBoard(const std::string &text, Board &board);
+
+enum class Solutions {
+    NONE, UNIQUE, MULTIPLE, UNKNOWN // limits reached before the count was known
+};
+
+// Limits of one call, 0 = no limit
+struct SolveLimits {
+    long long maxNodes = 0;
+    double maxSeconds = 0.0;
+    bool lockedCandidates = false; // add locked candidates to the propagation
+};
+
+// Uniqueness: the solutions of a board counted up to two. Boards whose givens repeat a digit in a
+// unit have none.
+Solutions countSolutions(const Board &board, const SolveLimits &limits = SolveLimits());
+
+// The first solution of a board, false if there is none or the limits were reached
+bool solve(const Board &board, Board &solution, const SolveLimits &limits = SolveLimits());
+
+// Checker: no digit twice in a row, column or box, empty cells allowed
+bool isConsistent(const Board &board);
+
+// Checker: a filled board without repetitions
+bool isSolved(const Board &board);
+
+// Formatter: the 81 cells on one line
+std::string formatLine(const Board &board);
+
+// Formatter: the grid with box separators, as the generator prints it
+std::string formatGrid(const Board &board);
+
+}
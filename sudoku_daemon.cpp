@@ -0,0 +1,258 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "sudoku_hint.cpp"
+#include "sudoku_inventory.cpp"
+
+using namespace std;
+
+// Resident generator serving puzzles over a Unix domain socket. Background workers keep the
+// inventory (see sudoku_inventory.cpp) filled, so a request is answered from memory; puzzles the
+// inventory cannot supply are generated by the connection thread while the client waits.
+//
+// The protocol is line based. A request
+//     GET <count> [<difficulty>|any] [<max clues>]
+// is answered by one line per puzzle, "<81 digits> <clues> <difficulty>", and a final line
+//     OK <puzzles> <generated on demand> <microseconds>
+// or "PARTIAL ..." with the same fields when the request timed out. "HINT <81 digits>" (0 or . for
+// empty cells) is answered by "HINT <next step>" or "CONFLICT <reason>", see sudoku_hint.cpp.
+// "STATS" returns the counters, "QUIT" closes the connection and malformed requests get "ERROR <message>".
+
+struct DaemonSettings {
+    string socketPath = "/tmp/sudoku.sock";
+    int bufferSize = 1000; // ready puzzles kept in memory per difficulty
+    int lowWater = 250; // a difficulty with fewer ready puzzles is refilled up to bufferSize
+    string inventoryPath; // inventory loaded on start and saved on shutdown, empty = not persisted
+    int workers = 0; // generator threads, 0 = one per hardware thread
+    double requestTimeout = 10.0; // seconds of on-demand generation per request
+    unsigned int seed = 1;
+};
+
+volatile sig_atomic_t daemonStopping = 0;
+
+void stopDaemon(int) {
+    daemonStopping = 1;
+}
+
+class PuzzleDaemon {
+public:
+    explicit PuzzleDaemon(const DaemonSettings &settings)
+            : settings(settings), inventory(settings.bufferSize, settings.lowWater) {}
+
+    // Serve until SIGINT or SIGTERM, returns false if the inventory or the socket cannot be opened
+    bool run() {
+        if (!settings.inventoryPath.empty()) {
+            if (!inventory.load(settings.inventoryPath)) return false;
+            cout << "Inventory " << inventoryStats() << endl;
+        }
+        if (!listen()) return false;
+        signal(SIGINT, stopDaemon);
+        signal(SIGTERM, stopDaemon);
+        signal(SIGPIPE, SIG_IGN);
+        int workers = settings.workers > 0 ? settings.workers : max(1, (int) thread::hardware_concurrency());
+        for (int worker = 0; worker < workers; ++worker) {
+            generators.emplace_back([this, worker] { generate(worker); });
+        }
+        cout << "Listening on " << settings.socketPath << " with " << workers << " generator threads" << endl;
+        while (!daemonStopping) {
+            pollfd ready{listener, POLLIN, 0};
+            if (poll(&ready, 1, 200) <= 0) continue;
+            int client = accept(listener, nullptr, nullptr);
+            if (client < 0) continue;
+            lock_guard<mutex> lock(clientsMutex);
+            clients.insert(client);
+            thread(&PuzzleDaemon::serve, this, client).detach();
+        }
+        shutdown();
+        return true;
+    }
+
+private:
+    bool listen() {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (settings.socketPath.size() >= sizeof(address.sun_path)) {
+            cerr << "Socket path too long: " << settings.socketPath << endl;
+            return false;
+        }
+        strcpy(address.sun_path, settings.socketPath.c_str());
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        unlink(settings.socketPath.c_str());
+        if (listener < 0 || bind(listener, (sockaddr *) &address, sizeof(address)) != 0 || ::listen(listener, 64) != 0) {
+            cerr << "Cannot listen on " << settings.socketPath << ": " << strerror(errno) << endl;
+            return false;
+        }
+        return true;
+    }
+
+    void shutdown() {
+        inventory.stop();
+        {
+            // Wake up the connections blocked in read and wait until they are closed
+            unique_lock<mutex> lock(clientsMutex);
+            for (int client: clients) {
+                ::shutdown(client, SHUT_RDWR);
+            }
+            closed.wait(lock, [this] { return clients.empty(); });
+        }
+        for (thread &t: generators) {
+            t.join();
+        }
+        close(listener);
+        unlink(settings.socketPath.c_str());
+        if (!settings.inventoryPath.empty() && inventory.save(settings.inventoryPath))
+            cout << "Saved inventory " << inventoryStats() << endl;
+        cout << "Stopped after serving " << served << " puzzles, " << dropped << " of " << generated
+             << " generated puzzles dropped" << endl;
+    }
+
+    void generate(int worker) {
+        seed_seq seeds{settings.seed, (unsigned int) worker};
+        mt19937 rng(seeds);
+        ParallelRemover remover(1);
+        ReadyPuzzle puzzle;
+        Difficulty difficulty;
+        while (!daemonStopping && inventory.nextRefill(difficulty)) {
+            generateForDifficulty(puzzle, difficulty, remover, rng);
+            generated++;
+            // A miss goes to the pool of its own difficulty, if that has room
+            if (!inventory.add(puzzle)) dropped++;
+        }
+    }
+
+    string inventoryStats() {
+        string stats;
+        for (int level = 0; level < DIFFICULTY_LEVELS; ++level) {
+            stats += string(level > 0 ? " " : "") + DIFFICULTY_NAMES[level] + " " + to_string(inventory.size(level));
+        }
+        return stats;
+    }
+
+    void serve(int client) {
+        seed_seq seeds{settings.seed, (unsigned int) client, (unsigned int) served.load()};
+        mt19937 rng(seeds);
+        ParallelRemover remover(1);
+        string pending;
+        char chunk[4096];
+        bool open = true;
+        while (open && !daemonStopping) {
+            ssize_t received = read(client, chunk, sizeof(chunk));
+            if (received <= 0) break;
+            pending.append(chunk, (size_t) received);
+            size_t end;
+            while (open && (end = pending.find('\n')) != string::npos) {
+                string request = pending.substr(0, end);
+                pending.erase(0, end + 1);
+                string response;
+                open = answer(request, response, remover, rng);
+                if (!response.empty() && write(client, response.data(), response.size()) < 0) open = false;
+            }
+        }
+        lock_guard<mutex> lock(clientsMutex);
+        clients.erase(client);
+        close(client);
+        closed.notify_all();
+    }
+
+    // Returns false when the client asked to close the connection
+    bool answer(const string &request, string &response, ParallelRemover &remover, mt19937 &rng) {
+        istringstream in(request);
+        string command;
+        in >> command;
+        if (command == "QUIT") return false;
+        if (command == "HINT") {
+            string digits;
+            in >> digits;
+            uint8_t board[KERNEL_CELLS];
+            bool valid = digits.size() == KERNEL_CELLS;
+            for (int cell = 0; valid && cell < KERNEL_CELLS; ++cell) {
+                char c = digits[cell];
+                valid = c == '.' || (c >= '0' && c <= '9');
+                board[cell] = (uint8_t) (c == '.' ? 0 : c - '0');
+            }
+            if (!valid) {
+                response = "ERROR expected HINT <81 digits>\n";
+                return true;
+            }
+            Hint hint = findHint(board, solveBudget);
+            response = (hint.kind == HINT_CONFLICT ? "CONFLICT " : "HINT ") + describeHint(hint) + "\n";
+            return true;
+        }
+        if (command == "STATS") {
+            response = "STATS " + inventoryStats() + " generated " + to_string(generated.load()) +
+                       " dropped " + to_string(dropped.load()) + " served " + to_string(served.load()) + "\n";
+            return true;
+        }
+        int count = 0, maxClues = KERNEL_CELLS;
+        string level = "any";
+        if (command != "GET" || !(in >> count) || count < 1) {
+            response = "ERROR expected GET <count> [<difficulty>|any] [<max clues>]\n";
+            return true;
+        }
+        in >> level >> maxClues;
+        Difficulty difficulty = EASY;
+        if (level != "any" && !parseDifficulty(level, difficulty)) {
+            response = "ERROR unknown difficulty " + level + "\n";
+            return true;
+        }
+        int wanted = level == "any" ? -1 : (int) difficulty;
+
+        auto start = chrono::steady_clock::now();
+        vector<ReadyPuzzle> puzzles;
+        inventory.take(count, wanted, maxClues, puzzles);
+        int onDemand = 0;
+        ReadyPuzzle puzzle;
+        uint8_t solution[KERNEL_CELLS];
+        while ((int) puzzles.size() < count && !daemonStopping &&
+               chrono::duration<double>(chrono::steady_clock::now() - start).count() < settings.requestTimeout) {
+            if (wanted < 0) generatePuzzle(puzzle, solution, remover, rng);
+            else generateForDifficulty(puzzle, difficulty, remover, rng);
+            generated++;
+            if (matches(puzzle, wanted, maxClues)) {
+                puzzles.push_back(puzzle);
+                onDemand++;
+            } else {
+                // Keep the puzzle for another request, it is dropped if its pool is full
+                if (!inventory.add(puzzle)) dropped++;
+            }
+        }
+        for (const ReadyPuzzle &ready: puzzles) {
+            for (uint8_t digit: ready.cells) {
+                response += (char) ('0' + digit);
+            }
+            response += " " + to_string(ready.clues) + " " + DIFFICULTY_NAMES[ready.difficulty] + "\n";
+        }
+        served += (long long) puzzles.size();
+        long long micros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        response += string((int) puzzles.size() == count ? "OK " : "PARTIAL ") + to_string(puzzles.size()) + " " +
+                    to_string(onDemand) + " " + to_string(micros) + "\n";
+        return true;
+    }
+
+    DaemonSettings settings;
+    Inventory inventory;
+    int listener = -1;
+    vector<thread> generators;
+    mutex clientsMutex;
+    condition_variable closed;
+    set<int> clients; // open connections, each served by a detached thread
+    atomic<long long> generated{0}, served{0};
+    atomic<long long> dropped{0}; // generated puzzles thrown away because their pool was full
+};
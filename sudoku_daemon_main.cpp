@@ -0,0 +1,64 @@
+#include <ctime>
+#include <string>
+#include <vector>
+#include "sudoku_daemon.cpp"
+#include "sudoku_options.cpp"
+
+using namespace std;
+
+// The puzzle daemon (see sudoku_daemon.cpp) as a program of its own, built on sudoku_core without
+// GAlib
+
+struct DaemonConfig {
+    string socketPath = "/tmp/sudoku.sock";
+    int bufferSize = 1000; // per difficulty
+    int lowWater = 250;
+    string inventoryPath;
+    float requestTimeout = 10.0; // seconds
+    int threads = 0; // 0 = one per hardware thread
+    SolverConfig solver;
+    int seed = 0; // 0 seeds from the current time
+};
+
+vector<ConfigOption> configOptions(DaemonConfig &config) {
+    vector<ConfigOption> options = {
+            {"socket",          CONFIG_TEXT,  &config.socketPath,     "Unix socket path"},
+            {"buffer-size",     CONFIG_INT,   &config.bufferSize,     "ready puzzles kept in memory per difficulty"},
+            {"low-water",       CONFIG_INT,   &config.lowWater,       "ready puzzles below which a difficulty is refilled"},
+            {"inventory",       CONFIG_TEXT,  &config.inventoryPath,  "file the ready puzzles are saved to on shutdown and loaded from"},
+            {"request-timeout", CONFIG_FLOAT, &config.requestTimeout, "seconds of on-demand generation per request"},
+            {"threads",         CONFIG_INT,   &config.threads,        "generator threads, 0 = one per hardware thread"},
+            {"seed",            CONFIG_INT,   &config.seed,           "random seed, 0 seeds from the current time"},
+    };
+    addSolverOptions(options, config.solver);
+    return options;
+}
+
+bool validateConfig(const DaemonConfig &config) {
+    vector<string> errors;
+    if (config.bufferSize < 1) errors.push_back("buffer-size must be at least 1");
+    if (config.lowWater < 1 || config.lowWater > config.bufferSize)
+        errors.push_back("low-water must be between 1 and buffer-size");
+    if (config.requestTimeout < 0) errors.push_back("request-timeout must not be negative");
+    if (config.threads < 0) errors.push_back("threads must not be negative");
+    validateSolverConfig(config.solver, errors);
+    if (config.seed < 0) errors.push_back("seed must not be negative");
+    return reportConfigErrors(errors);
+}
+
+int main(int argc, char **argv) {
+    DaemonConfig config;
+    if (!parseArguments(argc, argv, config)) return 1;
+
+    applySolverConfig(config.solver);
+    DaemonSettings settings;
+    settings.socketPath = config.socketPath;
+    settings.bufferSize = config.bufferSize;
+    settings.lowWater = config.lowWater;
+    settings.inventoryPath = config.inventoryPath;
+    settings.workers = config.threads;
+    settings.requestTimeout = config.requestTimeout;
+    settings.seed = config.seed ? (unsigned int) config.seed : static_cast<unsigned int>(time(nullptr));
+    PuzzleDaemon daemon(settings);
+    return daemon.run() ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "sudoku_propagation.h"
+
+using namespace std;
+
+// Difficulty of a unique puzzle: the weakest set of propagation rules that solves it without
+// guessing. Easy puzzles fall to naked singles, medium ones also need hidden singles, hard ones
+// locked candidates, and expert puzzles cannot be solved without search.
+enum Difficulty {
+    EASY, MEDIUM, HARD, EXPERT
+};
+
+const int DIFFICULTY_LEVELS = 4;
+
+const char *const DIFFICULTY_NAMES[DIFFICULTY_LEVELS] = {"easy", "medium", "hard", "expert"};
+
+// Returns false if name is not a difficulty
+bool parseDifficulty(const string &name, Difficulty &difficulty) {
+    for (int level = 0; level < DIFFICULTY_LEVELS; ++level) {
+        if (name == DIFFICULTY_NAMES[level]) {
+            difficulty = (Difficulty) level;
+            return true;
+        }
+    }
+    return false;
+}
+
+Difficulty rateDifficulty(const uint8_t *board) {
+    PropagationOptions options;
+    SolverStats stats;
+    for (int level = EASY; level < EXPERT; ++level) {
+        options.hiddenSingles = level >= MEDIUM;
+        options.lockedCandidates = level >= HARD;
+        CandidateBoard candidates(board);
+        if (propagate(candidates, options, stats) && candidates.empty == 0) return (Difficulty) level;
+    }
+    return EXPERT;
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "sudoku_checkpoint.cpp"
+#include "sudoku_population.cpp"
+#include "sudoku_seeds.cpp"
+#include "sudoku_threads.cpp"
+
+using namespace std;
+
+// What the generation loop needs from a GA implementation
+class GAEngine {
+public:
+    virtual ~GAEngine() {}
+
+    virtual void initialize() = 0;
+
+    virtual void step() = 0;
+
+    virtual float bestFitness() const = 0;
+
+    virtual void bestBoard(uint8_t *board) const = 0;
+
+    virtual int populationSize() const = 0;
+
+    virtual void setPopulationSize(int size) = 0;
+
+    virtual void setMutationProbability(float p) = 0;
+
+    // Re-initialize the population except for the best keepFraction of it
+    virtual void restart(float keepFraction) = 0;
+
+    // Generations left in the run, for engines that keep their own budget
+    virtual void setRemainingGenerations(int) {}
+
+    virtual void fitnessStatistics(float &mean, float &stddev) const = 0;
+
+    // The current population in packed form, for the diversity in the telemetry
+    virtual const Population &packedPopulation() = 0;
+
+    // Boards evaluated so far and fitness cache lookups
+    virtual long long evaluationCount() const = 0;
+
+    virtual void cacheCounts(long long &hits, long long &misses) const = 0;
+
+    // Complete state for a checkpoint, so that a run continued after loadState takes exactly the same
+    // course. Engines whose state cannot be captured return false.
+    virtual bool saveState(CheckpointWriter &) const {
+        return false;
+    }
+
+    virtual bool loadState(CheckpointReader &) {
+        return false;
+    }
+};
+
+// Parameters of the steady-state engine
+struct SteadyStateParameters {
+    int populationSize = 20000;
+    float crossoverProbability = 0.01;
+    float mutationProbability = 0.05;
+    int tournamentSize = 3;
+    float replacementRate = 0.5; // fraction of the population replaced by offspring every generation
+    int eliteCount = 10; // best individuals that are never replaced
+    int threads = 0; // 0 = one per hardware thread
+    unsigned int seed = 1;
+    const SeedGrids *seedGrids = nullptr; // known valid grids for fresh individuals
+    float seedFraction = 0.0; // share of the fresh individuals taken from seedGrids
+};
+
+// Steady-state GA on the packed population: every generation a share of the population is bred by
+// tournament selection, crossover and mutation and replaces the worst individuals, so the elites
+// survive. Breeding and evaluation run in parallel, every worker with its own random engine and
+// fitness cache. The population and offspring slabs are allocated once and reused.
+class SteadyStateEngine : public GAEngine {
+public:
+    explicit SteadyStateEngine(const SteadyStateParameters &parameters)
+            : params(parameters), pool(parameters.threads) {
+        for (int worker = 0; worker < pool.size(); ++worker) {
+            seed_seq seeds{params.seed, (unsigned int) worker};
+            engines.emplace_back(seeds);
+        }
+        caches.resize(pool.size());
+        evaluated.assign(pool.size(), 0);
+    }
+
+    void initialize() override {
+        population.resize(params.populationSize);
+        pool.run([this](int worker) {
+            int begin, end;
+            workerRange(worker, pool.size(), population.size(), begin, end);
+            for (int i = begin; i < end; ++i) {
+                freshIndividual(population.genes(i), engines[worker]);
+            }
+            evaluated[worker] += evaluatePopulationCached(population, begin, end, caches[worker]);
+        });
+        findBest();
+    }
+
+    void step() override {
+        int size = population.size();
+        int offspringCount = (int) (size * params.replacementRate) & ~1;
+        offspringCount = max(2, min(offspringCount, (size - params.eliteCount) & ~1));
+        offspring.resize(offspringCount);
+        int pairs = offspringCount / 2;
+
+        pool.run([this, pairs](int worker) {
+            int begin, end;
+            workerRange(worker, pool.size(), pairs, begin, end);
+            mt19937 &rng = engines[worker];
+            uniform_real_distribution<float> coin(0.0f, 1.0f);
+            for (int pair = begin; pair < end; ++pair) {
+                int mother = tournament(rng);
+                int father = tournament(rng);
+                uint8_t *child1 = offspring.genes(2 * pair);
+                uint8_t *child2 = offspring.genes(2 * pair + 1);
+                if (coin(rng) < params.crossoverProbability) {
+                    crossoverBoards(population.genes(mother), population.genes(father), child1, child2, rng);
+                } else {
+                    memcpy(child1, population.genes(mother), GENOME_LENGTH);
+                    memcpy(child2, population.genes(father), GENOME_LENGTH);
+                }
+                mutateBoard(child1, params.mutationProbability, rng);
+                mutateBoard(child2, params.mutationProbability, rng);
+            }
+            evaluated[worker] += evaluatePopulationCached(offspring, 2 * begin, 2 * end, caches[worker]);
+        });
+
+        // Replace the worst individuals by the offspring
+        order.resize(size);
+        iota(order.begin(), order.end(), 0);
+        nth_element(order.begin(), order.begin() + offspringCount, order.end(), [this](int a, int b) {
+            return population.fitness(a) < population.fitness(b);
+        });
+        for (int i = 0; i < offspringCount; ++i) {
+            population.copyIndividual(order[i], offspring, i);
+        }
+        findBest();
+    }
+
+    float bestFitness() const override {
+        return population.fitness(best);
+    }
+
+    void bestBoard(uint8_t *board) const override {
+        memcpy(board, population.genes(best), GENOME_LENGTH);
+    }
+
+    int populationSize() const override {
+        return population.size();
+    }
+
+    // Shrinking drops the worst individuals, growing fills the new slots with fresh individuals
+    void setPopulationSize(int size) override {
+        int old = population.size();
+        if (size == old || size < 2) return;
+        if (size < old) {
+            sortByFitness();
+            Population kept(size);
+            for (int i = 0; i < size; ++i) {
+                kept.copyIndividual(i, population, order[i]);
+            }
+            population.swap(kept);
+        } else {
+            population.resize(size);
+            for (int i = old; i < size; ++i) {
+                freshIndividual(population.genes(i), engines[0]);
+            }
+            evaluated[0] += evaluatePopulationCached(population, old, size, caches[0]);
+        }
+        params.populationSize = size;
+        findBest();
+    }
+
+    void setMutationProbability(float p) override {
+        params.mutationProbability = p;
+    }
+
+    // Rebuilt in place: the kept individuals are staged in the offspring slab and moved to the front,
+    // the rest is replaced by fresh individuals, so no memory is allocated
+    void restart(float keepFraction) override {
+        int size = population.size();
+        int keep = max(1, min(size, (int) (size * keepFraction)));
+        sortByFitness();
+        offspring.resize(keep);
+        for (int i = 0; i < keep; ++i) {
+            offspring.copyIndividual(i, population, order[i]);
+        }
+        for (int i = 0; i < keep; ++i) {
+            population.copyIndividual(i, offspring, i);
+        }
+        pool.run([this, keep, size](int worker) {
+            int begin, end;
+            workerRange(worker, pool.size(), size - keep, begin, end);
+            for (int i = keep + begin; i < keep + end; ++i) {
+                freshIndividual(population.genes(i), engines[worker]);
+            }
+            evaluated[worker] += evaluatePopulationCached(population, keep + begin, keep + end, caches[worker]);
+        });
+        findBest();
+    }
+
+    void fitnessStatistics(float &mean, float &stddev) const override {
+        double sum = 0.0, squares = 0.0;
+        for (int i = 0; i < population.size(); ++i) {
+            sum += population.fitness(i);
+            squares += (double) population.fitness(i) * population.fitness(i);
+        }
+        double n = population.size();
+        mean = (float) (sum / n);
+        stddev = (float) sqrt(max(0.0, squares / n - (sum / n) * (sum / n)));
+    }
+
+    const Population &packedPopulation() override {
+        return population;
+    }
+
+    long long evaluationCount() const override {
+        return accumulate(evaluated.begin(), evaluated.end(), 0LL);
+    }
+
+    void cacheCounts(long long &hits, long long &misses) const override {
+        hits = misses = 0;
+        for (const FitnessCache &cache: caches) {
+            hits += cache.hits;
+            misses += cache.misses;
+        }
+    }
+
+    // The fitness caches are left out, they only save evaluations. The work is split by worker, so
+    // the state only carries over to an engine with the same number of threads.
+    bool saveState(CheckpointWriter &out) const override {
+        out.put(pool.size());
+        out.put(params.populationSize);
+        out.put(params.mutationProbability);
+        for (int worker = 0; worker < pool.size(); ++worker) {
+            out.putEngine(engines[worker]);
+            out.put(evaluated[worker]);
+        }
+        out.put(population.size());
+        for (int i = 0; i < population.size(); ++i) {
+            out.putBytes(population.genes(i), GENOME_LENGTH);
+            out.put(population.fitness(i));
+        }
+        return true;
+    }
+
+    bool loadState(CheckpointReader &in) override {
+        int workers = 0, size = 0;
+        if (!in.get(workers) || workers != pool.size()) {
+            cerr << "Checkpoint was taken with " << workers << " threads, not " << pool.size() << endl;
+            return false;
+        }
+        in.get(params.populationSize);
+        in.get(params.mutationProbability);
+        for (int worker = 0; worker < pool.size(); ++worker) {
+            in.getEngine(engines[worker]);
+            in.get(evaluated[worker]);
+        }
+        if (!in.get(size) || size < 2 || (size_t) size > in.remaining() / GENOME_LENGTH) return false;
+        population.resize(size);
+        for (int i = 0; i < size; ++i) {
+            in.getBytes(population.genes(i), GENOME_LENGTH);
+            in.get(population.fitness(i));
+        }
+        findBest();
+        return in.good();
+    }
+
+private:
+    int tournament(mt19937 &rng) const {
+        uniform_int_distribution<int> pick(0, population.size() - 1);
+        int winner = pick(rng);
+        for (int i = 1; i < params.tournamentSize; ++i) {
+            int challenger = pick(rng);
+            if (population.fitness(challenger) > population.fitness(winner)) winner = challenger;
+        }
+        return winner;
+    }
+
+    void freshIndividual(uint8_t *board, mt19937 &rng) const {
+        initializeIndividual(board, params.seedGrids, params.seedFraction, rng);
+    }
+
+    // Indices of the population in order of decreasing fitness
+    void sortByFitness() {
+        order.resize(population.size());
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [this](int a, int b) {
+            return population.fitness(a) > population.fitness(b);
+        });
+    }
+
+    void findBest() {
+        best = 0;
+        for (int i = 1; i < population.size(); ++i) {
+            if (population.fitness(i) > population.fitness(best)) best = i;
+        }
+    }
+
+    SteadyStateParameters params;
+    WorkerPool pool;
+    vector<mt19937> engines;
+    vector<FitnessCache> caches;
+    vector<long long> evaluated;
+    Population population, offspring;
+    vector<int> order;
+    int best = 0;
+};
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <ga/GA1DArrayGenome.h>
+#include <ga/GAPopulation.h>
+#include <ga/GASimpleGA.h>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include "sudoku_solver.h"
+#include "sudoku_scratch.cpp"
+#include "sudoku_population.cpp"
+#include "sudoku_engine.cpp"
+#include "sudoku_seeds.cpp"
+#include "sudoku_removal.cpp"
+
+using namespace std;
+
+// Scratch board of the current thread, shared by the initializer, the objective and the removal
+thread_local ScratchBoard grid;
+
+// Number of boards actually evaluated (fitness cache misses included, hits not), reported by the telemetry
+long long evaluations = 0;
+
+// Fitness of recently evaluated boards, shared by the generations of a run
+FitnessCache fitnessCache;
+
+// Random engine of the GA operators, seeded once so that runs can be reproduced
+mt19937 generator;
+
+// Known valid grids, a seedFraction share of the initialized individuals is taken from them
+SeedGrids seedGrids;
+float seedFraction = 0.0;
+
+void seedRandom(unsigned int seed) {
+    srand(seed);
+    GARandomSeed(seed);
+    generator.seed(seed);
+}
+
+// Convert the genome to a Sudoku grid
+void genomeToGrid(const GA1DArrayGenome<int> &genome) {
+    for (int i = 0; i < GRID_SIDE; ++i) {
+        for (int j = 0; j < GRID_SIDE; ++j) {
+            grid[i][j] = genome.gene(i * GRID_SIDE + j);
+        }
+    }
+}
+
+// Copy the genes of a genome into a packed board and back
+void packGenome(const GA1DArrayGenome<int> &genome, uint8_t *board) {
+    for (int i = 0; i < GENOME_LENGTH; ++i) {
+        board[i] = (uint8_t) genome.gene(i);
+    }
+}
+
+void unpackGenome(const uint8_t *board, GA1DArrayGenome<int> &genome) {
+    for (int i = 0; i < GENOME_LENGTH; ++i) {
+        genome.gene(i, board[i]);
+    }
+}
+
+void packPopulation(const GAPopulation &from, Population &to) {
+    to.resize(from.size());
+    for (int i = 0; i < (int) from.size(); ++i) {
+        packGenome((GA1DArrayGenome<int> &) from.individual(i), to.genes(i));
+    }
+}
+
+// Objective function
+float objective(GAGenome &g) {
+    auto &genome = (GA1DArrayGenome<int> &) g;
+    uint8_t board[GENOME_LENGTH];
+    packGenome(genome, board);
+    evaluations++;
+    return boardObjective(board);
+}
+
+// Population evaluator: scores the whole population in one batch instead of genome by genome,
+// genomes whose board is in the fitness cache are not evaluated again
+void populationEvaluator(GAPopulation &population) {
+    thread_local Population packed;
+    packPopulation(population, packed);
+    evaluations += evaluatePopulationCached(packed, 0, packed.size(), fitnessCache);
+    for (int i = 0; i < packed.size(); ++i) {
+        population.individual(i).score(packed.fitness(i));
+    }
+}
+
+// Initializer
+void initializer(GAGenome &g) {
+    auto &genome = (GA1DArrayGenome<int> &) g;
+    uint8_t board[GENOME_LENGTH];
+    initializeIndividual(board, &seedGrids, seedFraction, generator);
+    unpackGenome(board, genome);
+}
+
+// Mutator
+int mutator(GAGenome &g, float p) {
+    auto &genome = (GA1DArrayGenome<int> &) g;
+    int nMutations = 0;
+    if (GAFlipCoin(p)) {
+        // Pick two random positions
+        int pos1 = rand() % (GRID_SIDE * GRID_SIDE);
+        int pos2 = rand() % (GRID_SIDE * GRID_SIDE);
+        // Ensure pos1 and pos2 are different
+        while (pos2 == pos1) {
+            pos2 = rand() % (GRID_SIDE * GRID_SIDE);
+        }
+        int tmp = genome.gene(pos1);
+        genome.gene(pos1, genome.gene(pos2));
+        genome.gene(pos2, tmp);
+
+        nMutations++;
+    }
+    return nMutations;
+}
+
+// Crossover
+int crossover(const GAGenome &p1, const GAGenome &p2, GAGenome *c1, GAGenome *c2) {
+    auto &parent1 = (GA1DArrayGenome<int> &) p1;
+    auto &parent2 = (GA1DArrayGenome<int> &) p2;
+    if (c1 && c2) {
+        auto &child1 = (GA1DArrayGenome<int> &) *c1;
+        auto &child2 = (GA1DArrayGenome<int> &) *c2;
+
+        // cut at the end of line 3 or 6
+        int cut = ((rand() % 2) + 1) * 3 * GRID_SIDE;
+        for (int i = 0; i < GRID_SIDE * GRID_SIDE; i++) {
+            if (i < cut) {
+                child1.gene(i, parent1.gene(i));
+                child2.gene(i, parent2.gene(i));
+            } else {
+                child1.gene(i, parent2.gene(i));
+                child2.gene(i, parent1.gene(i));
+            }
+        }
+        return 2;
+    } else if (c1) {
+        auto &child = (GA1DArrayGenome<int> &) *c1;
+        int cut = rand() % (GRID_SIDE * GRID_SIDE);
+        for (int i = 0; i < GRID_SIDE * GRID_SIDE; i++) {
+            if (i < cut) {
+                child.gene(i, parent1.gene(i));
+            } else {
+                child.gene(i, parent2.gene(i));
+            }
+        }
+        return 1;
+    } else {
+        return 0;
+    }
+}
+
+// Clue removal stops once a puzzle has more empty cells than this
+const int MAX_EMPTY_CELLS = 55;
+
+bool backtrackRemoveNumbers(GA1DArrayGenome<int> &genome) {
+    genomeToGrid(genome);
+    if(countZeros(grid) > MAX_EMPTY_CELLS) return true;
+    for (int i = 0; i < GRID_SIDE * GRID_SIDE; ++i) {
+        if (genome.gene(i) != 0) {
+            int originalValue = genome.gene(i);
+            genome.gene(i, 0);
+            genomeToGrid(genome);
+
+            // A removal is only kept when uniqueness is proven, a call that runs out of budget counts as ambiguous
+            if (solveSudoku(grid)) {
+                if (backtrackRemoveNumbers(genome)) {
+                    // If the remaining sudoku is solvable, we found a solution
+                    return true;
+                }
+            }
+
+            // Revert the change
+            genome.gene(i, originalValue);
+        }
+    }
+    return false;  // No solution found
+}
+
+void removeNumbers(GA1DArrayGenome<int> &bestGenome) {
+    GA1DArrayGenome<int> bestGenomeCopy = bestGenome;
+    genomeToGrid(bestGenomeCopy);
+    if (backtrackRemoveNumbers(bestGenomeCopy)) {
+        // If backtracking was successful, update the original bestGenome
+        bestGenome = bestGenomeCopy;
+    }
+}
+
+// Greedy removal with the uniqueness checks on the workers of remover. Unlike removeNumbers it does
+// not backtrack: a puzzle that becomes minimal before the cap is kept as it is.
+// With untilMinimal there is no cap, clues are removed until none can be.
+void removeNumbersParallel(GA1DArrayGenome<int> &bestGenome, ParallelRemover &remover, bool untilMinimal = false) {
+    uint8_t board[GENOME_LENGTH];
+    packGenome(bestGenome, board);
+    remover.removeClues(board, untilMinimal ? GENOME_LENGTH : MAX_EMPTY_CELLS + 1);
+    unpackGenome(board, bestGenome);
+}
+
+bool isMinimalPuzzle(GA1DArrayGenome<int> &genome, ParallelRemover &remover) {
+    uint8_t board[GENOME_LENGTH];
+    packGenome(genome, board);
+    return remover.isMinimal(board);
+}
+
+// GASimpleGA behind the engine interface of the generation loop
+class GAlibEngine : public GAEngine {
+public:
+    GAlibEngine(float crossoverProbability, float mutationProbability)
+            : genome(GRID_SIDE * GRID_SIDE, objective), ga(configure(genome)) {
+        GAPopulation initialPopulation(ga.population());
+        initialPopulation.evaluator(populationEvaluator);
+        ga.population(initialPopulation);
+        ga.pMutation(mutationProbability);
+        ga.pCrossover(crossoverProbability);
+    }
+
+    void initialize() override {
+        ga.initialize();
+    }
+
+    void step() override {
+        ga.step();
+    }
+
+    float bestFitness() const override {
+        return ga.statistics().bestIndividual().score();
+    }
+
+    void bestBoard(uint8_t *board) const override {
+        packGenome((GA1DArrayGenome<int> &) ga.statistics().bestIndividual(), board);
+    }
+
+    int populationSize() const override {
+        return (int) ga.population().size();
+    }
+
+    void setPopulationSize(int size) override {
+        ga.populationSize(size);
+    }
+
+    void setMutationProbability(float p) override {
+        ga.pMutation(p);
+    }
+
+    // Rebuilt in place: the best individuals are copied aside, then the individuals of the population
+    // are re-initialized and the copies written back, so no genome is allocated after the first restart
+    void restart(float keepFraction) override {
+        const GAPopulation &population = ga.population();
+        int size = (int) population.size();
+        int keep = max(1, min(size, (int) (size * keepFraction)));
+        if ((int) elites.size() < keep) elites.resize(keep, genome);
+        for (int i = 0; i < keep; ++i) {
+            elites[i].copy(population.best(i));
+        }
+        for (int i = 0; i < size; ++i) {
+            if (i < keep) population.individual(i).copy(elites[i]);
+            else population.individual(i).initialize();
+        }
+        population.evaluate(gaTrue);
+    }
+
+    void setRemainingGenerations(int generations) override {
+        ga.nGenerations(generations);
+    }
+
+    void fitnessStatistics(float &mean, float &stddev) const override {
+        mean = ga.population().ave();
+        stddev = ga.population().dev();
+    }
+
+    const Population &packedPopulation() override {
+        packPopulation(ga.population(), packed);
+        return packed;
+    }
+
+    long long evaluationCount() const override {
+        return evaluations;
+    }
+
+    void cacheCounts(long long &hits, long long &misses) const override {
+        hits = fitnessCache.hits;
+        misses = fitnessCache.misses;
+    }
+
+private:
+    static GA1DArrayGenome<int> &configure(GA1DArrayGenome<int> &g) {
+        g.initializer(initializer);
+        g.mutator(mutator);
+        g.crossover(crossover);
+        return g;
+    }
+
+    GA1DArrayGenome<int> genome;
+    GASimpleGA ga;
+    Population packed;
+    vector<GA1DArrayGenome<int>> elites;
+};
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "sudoku_search.h"
+
+using namespace std;
+
+// Hints for interactive clients: the next digit a player can place on a partial grid. The rules of
+// the propagation are tried one at a time on the candidate masks, easiest first, and the first
+// naked or hidden single is the hint. Eliminations by locked candidates do not show in a grid of
+// digits, so they are applied until a single appears and the hint names the last one as its reason.
+// Only when no rule applies is the grid searched, to tell a dead end from a grid that needs a guess.
+// Grids that break a rule get a conflict report instead.
+
+enum HintKind {
+    HINT_PLACE, // digit goes into cell
+    HINT_CONFLICT, // the grid cannot be completed, technique says why
+    HINT_SOLVED,
+    HINT_STUCK // no deduction and no unique solution to take one from
+};
+
+struct Hint {
+    HintKind kind = HINT_STUCK;
+    const char *technique = "";
+    int cell = -1; // placed cell, or the cell of a conflict
+    int digit = 0;
+    int unit = -1; // unit of a hidden single or of a conflict
+    int otherCell = -1; // second cell of a duplicate
+    // Locked candidates applied before the placement, the last of them: lockedDigit confined to
+    // lockedUnit leaves the eliminated cells
+    int lockedSteps = 0;
+    const char *lockedTechnique = "";
+    int lockedUnit = -1;
+    int lockedDigit = 0;
+    uint8_t eliminated[6];
+    int eliminatedCount = 0;
+};
+
+// Units in the order hints look at them: boxes, where players look first, then rows and columns
+const int HINT_UNIT_ORDER[KERNEL_UNITS] = {18, 19, 20, 21, 22, 23, 24, 25, 26, 0, 1, 2, 3, 4, 5, 6, 7, 8,
+                                           9, 10, 11, 12, 13, 14, 15, 16, 17};
+
+string unitName(int unit) {
+    const char *kinds[] = {"row ", "column ", "box "};
+    return kinds[unit / KERNEL_SIDE] + to_string(unit % KERNEL_SIDE + 1);
+}
+
+// The same digit twice in a unit
+bool findDuplicate(const uint8_t *board, Hint &hint) {
+    for (int unit: HINT_UNIT_ORDER) {
+        int seen[KERNEL_SIDE + 1];
+        for (int &cell: seen) cell = -1;
+        for (uint8_t cell: unitCells.cells[unit]) {
+            int digit = board[cell];
+            if (digit == 0) continue;
+            if (seen[digit] >= 0) {
+                hint.kind = HINT_CONFLICT;
+                hint.technique = "duplicate";
+                hint.digit = digit;
+                hint.unit = unit;
+                hint.cell = seen[digit];
+                hint.otherCell = cell;
+                return true;
+            }
+            seen[digit] = cell;
+        }
+    }
+    return false;
+}
+
+// An empty cell without candidates or a digit without a place in a unit
+bool findDeadEnd(const CandidateBoard &board, Hint &hint) {
+    for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+        if (board.cells[cell] != 0 || board.candidates[cell] != 0) continue;
+        hint.kind = HINT_CONFLICT;
+        hint.technique = "no candidates";
+        hint.cell = cell;
+        return true;
+    }
+    for (int unit: HINT_UNIT_ORDER) {
+        uint16_t covered = 0;
+        for (uint8_t cell: unitCells.cells[unit]) {
+            covered |= (uint16_t) (board.candidates[cell] | (1u << board.cells[cell]));
+        }
+        uint16_t missing = (uint16_t) (ALL_DIGITS & ~covered);
+        if (!missing) continue;
+        hint.kind = HINT_CONFLICT;
+        hint.technique = "no place";
+        hint.digit = __builtin_ctz(missing);
+        hint.unit = unit;
+        return true;
+    }
+    return false;
+}
+
+bool findNakedSingle(const CandidateBoard &board, Hint &hint) {
+    for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+        uint16_t mask = board.candidates[cell];
+        if (board.cells[cell] != 0 || (mask & (mask - 1))) continue;
+        hint.kind = HINT_PLACE;
+        hint.technique = "naked single";
+        hint.cell = cell;
+        hint.digit = __builtin_ctz(mask);
+        return true;
+    }
+    return false;
+}
+
+bool findHiddenSingle(const CandidateBoard &board, Hint &hint) {
+    for (int unit: HINT_UNIT_ORDER) {
+        uint16_t once = 0, twice = 0;
+        for (uint8_t cell: unitCells.cells[unit]) {
+            twice |= once & board.candidates[cell];
+            once |= board.candidates[cell];
+        }
+        uint16_t hidden = once & ~twice;
+        if (!hidden) continue;
+        int digit = __builtin_ctz(hidden);
+        for (uint8_t cell: unitCells.cells[unit]) {
+            if (!(board.candidates[cell] & (1u << digit))) continue;
+            hint.kind = HINT_PLACE;
+            hint.technique = "hidden single";
+            hint.cell = cell;
+            hint.digit = digit;
+            hint.unit = unit;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Locked candidates with the same tables as the propagation: a digit of a box confined to one line
+// (pointing) leaves the rest of the line, a digit of a line confined to one box (claiming) the rest
+// of the box
+bool findLockedCandidates(const CandidateBoard &board, Hint &hint) {
+    for (int i = 0; i < 2 * KERNEL_SIDE * 3; ++i) {
+        uint16_t inBoth = 0, onlyLine = 0, onlyBox = 0;
+        for (uint8_t cell: propagationTables.intersection[i]) inBoth |= board.candidates[cell];
+        for (uint8_t cell: propagationTables.lineRest[i]) onlyLine |= board.candidates[cell];
+        for (uint8_t cell: propagationTables.boxRest[i]) onlyBox |= board.candidates[cell];
+        uint16_t pointing = inBoth & ~onlyBox & onlyLine;
+        uint16_t claiming = inBoth & ~onlyLine & onlyBox;
+        if (!(pointing | claiming)) continue;
+        bool isPointing = pointing != 0;
+        int digit = __builtin_ctz(isPointing ? pointing : claiming);
+        int line = i / 3;
+        int box = line < KERNEL_SIDE ? (line / 3) * 3 + i % 3 : (i % 3) * 3 + (line - KERNEL_SIDE) / 3;
+        hint.lockedTechnique = isPointing ? "pointing" : "claiming";
+        hint.lockedDigit = digit;
+        hint.lockedUnit = isPointing ? 2 * KERNEL_SIDE + box : line;
+        hint.eliminatedCount = 0;
+        for (uint8_t cell: isPointing ? propagationTables.lineRest[i] : propagationTables.boxRest[i]) {
+            if (board.candidates[cell] & (1u << digit)) hint.eliminated[hint.eliminatedCount++] = cell;
+        }
+        return true;
+    }
+    return false;
+}
+
+// The next step on a packed board, 0 for empty cells. The search at the end is bounded by budget.
+Hint findHint(const uint8_t *board, const SolveBudget &budget = SolveBudget()) {
+    Hint hint;
+    if (findDuplicate(board, hint)) return hint;
+    CandidateBoard candidates(board);
+    if (candidates.empty == 0) {
+        hint.kind = HINT_SOLVED;
+        hint.technique = "solved";
+        return hint;
+    }
+    if (findDeadEnd(candidates, hint) || findNakedSingle(candidates, hint) || findHiddenSingle(candidates, hint)) {
+        return hint;
+    }
+    // Every round removes at least one candidate
+    while (findLockedCandidates(candidates, hint)) {
+        hint.lockedSteps++;
+        for (int i = 0; i < hint.eliminatedCount; ++i) {
+            candidates.eliminate(hint.eliminated[i], (uint16_t) (1u << hint.lockedDigit));
+        }
+        if (findDeadEnd(candidates, hint) || findNakedSingle(candidates, hint) || findHiddenSingle(candidates, hint)) {
+            return hint;
+        }
+    }
+    hint.lockedSteps = 0;
+
+    // Nothing follows from the rules: the digit of the solution in the cell with the fewest candidates
+    PropagationOptions options;
+    options.lockedCandidates = true;
+    IterativeSolver solver(board, 2, options);
+    SolverStats stats;
+    if (!searchWithinBudget(solver, budget, stats)) {
+        hint.technique = "budget exhausted";
+    } else if (solver.solutions() == 0) {
+        hint.kind = HINT_CONFLICT;
+        hint.technique = "no solution";
+    } else if (solver.solutions() > 1) {
+        hint.technique = "multiple solutions";
+    } else {
+        int fewest = KERNEL_SIDE + 1;
+        for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+            int count = bitCounts.counts[candidates.candidates[cell]];
+            if (board[cell] != 0 || count >= fewest) continue;
+            fewest = count;
+            hint.cell = cell;
+        }
+        hint.kind = HINT_PLACE;
+        hint.technique = "search";
+        hint.digit = solver.solution()[hint.cell];
+    }
+    return hint;
+}
+
+// One line for a player, e.g. "hidden single in box 4: r5c2 = 7" or, after locked candidates,
+// "naked single: r1c1 = 3 after pointing in box 2 removes 5 from r1c7 r1c8"
+string describeHint(const Hint &hint) {
+    string text = hint.technique;
+    string locked;
+    if (hint.lockedSteps > 0) {
+        locked = string(" after ") + hint.lockedTechnique + " in " + unitName(hint.lockedUnit) + " removes " +
+                 to_string(hint.lockedDigit) + " from";
+        for (int i = 0; i < hint.eliminatedCount; ++i) {
+            locked += " " + cellName(hint.eliminated[i]);
+        }
+    }
+    switch (hint.kind) {
+        case HINT_PLACE:
+            if (hint.unit >= 0) text += " in " + unitName(hint.unit);
+            return text + ": " + cellName(hint.cell) + " = " + to_string(hint.digit) + locked;
+        case HINT_CONFLICT:
+            if (hint.otherCell >= 0) {
+                return text + " " + to_string(hint.digit) + " in " + unitName(hint.unit) + ": " +
+                       cellName(hint.cell) + " " + cellName(hint.otherCell);
+            }
+            if (hint.cell >= 0) return text + ": " + cellName(hint.cell) + locked;
+            if (hint.unit >= 0) return text + " for " + to_string(hint.digit) + " in " + unitName(hint.unit) + locked;
+            return text;
+        default:
+            return text;
+    }
+}
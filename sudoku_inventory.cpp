@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include "sudoku_difficulty.cpp"
+#include "sudoku_lowclue.cpp"
+
+using namespace std;
+
+// Inventory of ready puzzles: one bounded pool per difficulty. A pool that falls below its low-water
+// mark is refilled by the generator workers up to its capacity, so requests are served from memory
+// and refills come in batches instead of one puzzle per request. The pools can be saved to a file
+// on shutdown and loaded on start.
+
+struct ReadyPuzzle {
+    uint8_t cells[KERNEL_CELLS];
+    uint8_t clues;
+    uint8_t difficulty;
+};
+
+// A minimal puzzle on a random solution grid, clues removed in a random order. The solution is
+// written to solution.
+void generatePuzzle(ReadyPuzzle &puzzle, uint8_t *solution, ParallelRemover &remover, mt19937 &rng) {
+    thread_local vector<int> order;
+    if (order.empty()) {
+        order.resize(KERNEL_CELLS);
+        iota(order.begin(), order.end(), 0);
+    }
+    randomGrid(solution, rng);
+    memcpy(puzzle.cells, solution, KERNEL_CELLS);
+    shuffle(order.begin(), order.end(), rng);
+    remover.removeClues(puzzle.cells, KERNEL_CELLS, &order);
+    puzzle.clues = (uint8_t) clueCount(puzzle.cells);
+    puzzle.difficulty = (uint8_t) rateDifficulty(puzzle.cells);
+}
+
+// A puzzle for the given difficulty, or of another one when the attempt misses. Minimal puzzles
+// tend to be hard, so a puzzle that is harder than wanted gets clues of its solution back one at
+// a time until it is easy enough. A clue that would make it easier than wanted is taken out again,
+// so the puzzle does not overshoot to an easier level; a puzzle easier than wanted from the start
+// is a miss.
+void generateForDifficulty(ReadyPuzzle &puzzle, Difficulty wanted, ParallelRemover &remover, mt19937 &rng) {
+    uint8_t solution[KERNEL_CELLS];
+    generatePuzzle(puzzle, solution, remover, rng);
+    vector<int> empty;
+    for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+        if (puzzle.cells[cell] == 0) empty.push_back(cell);
+    }
+    shuffle(empty.begin(), empty.end(), rng);
+    for (size_t i = 0; i < empty.size() && puzzle.difficulty > wanted; ++i) {
+        puzzle.cells[empty[i]] = solution[empty[i]];
+        Difficulty rated = rateDifficulty(puzzle.cells);
+        if (rated < wanted) {
+            puzzle.cells[empty[i]] = 0;
+            continue;
+        }
+        puzzle.clues++;
+        puzzle.difficulty = (uint8_t) rated;
+    }
+}
+
+// A request matches puzzles of one difficulty (or any, -1) with at most maxClues clues
+bool matches(const ReadyPuzzle &puzzle, int difficulty, int maxClues) {
+    return (difficulty < 0 || puzzle.difficulty == difficulty) && puzzle.clues <= maxClues;
+}
+
+const char INVENTORY_MAGIC[8] = {'S', 'D', 'K', 'I', 'N', 'V', '0', '1'};
+
+class Inventory {
+public:
+    Inventory(int capacity, int lowWater) : capacity((size_t) capacity), lowWater((size_t) lowWater) {
+        for (bool &flag: refilling) flag = true;
+    }
+
+    // Add to the pool of the puzzle's difficulty, returns false if that pool is full
+    bool add(const ReadyPuzzle &puzzle) {
+        lock_guard<mutex> lock(mtx);
+        deque<ReadyPuzzle> &pool = pools[puzzle.difficulty];
+        if (pool.size() >= capacity) return false;
+        pool.push_back(puzzle);
+        if (pool.size() >= capacity) refilling[puzzle.difficulty] = false;
+        return true;
+    }
+
+    // Move up to count matching puzzles to out, oldest first, returns how many were taken
+    int take(int count, int difficulty, int maxClues, vector<ReadyPuzzle> &out) {
+        lock_guard<mutex> lock(mtx);
+        int taken = 0;
+        for (int level = 0; level < DIFFICULTY_LEVELS && taken < count; ++level) {
+            if (difficulty >= 0 && level != difficulty) continue;
+            deque<ReadyPuzzle> &pool = pools[level];
+            for (auto it = pool.begin(); it != pool.end() && taken < count;) {
+                if (!matches(*it, difficulty, maxClues)) {
+                    ++it;
+                    continue;
+                }
+                out.push_back(*it);
+                it = pool.erase(it);
+                taken++;
+            }
+            if (pool.size() < lowWater && !refilling[level]) {
+                refilling[level] = true;
+                refill.notify_all();
+            }
+        }
+        return taken;
+    }
+
+    // Blocks until a pool needs puzzles, returns false once stopped. The pools being refilled are
+    // handed out in turn, so a difficulty that is slow to generate does not hold up the others.
+    bool nextRefill(Difficulty &difficulty) {
+        unique_lock<mutex> lock(mtx);
+        int level = -1;
+        refill.wait(lock, [&] {
+            for (int i = 0; i < DIFFICULTY_LEVELS && level < 0; ++i) {
+                int candidate = (nextLevel + i) % DIFFICULTY_LEVELS;
+                if (refilling[candidate]) level = candidate;
+            }
+            return stopping || level >= 0;
+        });
+        if (stopping) return false;
+        difficulty = (Difficulty) level;
+        nextLevel = (level + 1) % DIFFICULTY_LEVELS;
+        return true;
+    }
+
+    size_t size(int difficulty) {
+        lock_guard<mutex> lock(mtx);
+        return pools[difficulty].size();
+    }
+
+    void stop() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        refill.notify_all();
+    }
+
+    // Binary snapshot: magic, then per difficulty a 32-bit count and the puzzles (cells, clues)
+    bool save(const string &path) {
+        lock_guard<mutex> lock(mtx);
+        ofstream out(path, ios::binary | ios::trunc);
+        out.write(INVENTORY_MAGIC, sizeof(INVENTORY_MAGIC));
+        for (const deque<ReadyPuzzle> &pool: pools) {
+            uint32_t count = (uint32_t) pool.size();
+            out.write((const char *) &count, sizeof(count));
+            for (const ReadyPuzzle &puzzle: pool) {
+                out.write((const char *) puzzle.cells, KERNEL_CELLS);
+                out.put((char) puzzle.clues);
+            }
+        }
+        if (!out) cerr << "Cannot write inventory " << path << endl;
+        return (bool) out;
+    }
+
+    // Returns false if the file exists but is not a valid snapshot, a missing file is an empty inventory
+    bool load(const string &path) {
+        ifstream in(path, ios::binary);
+        if (!in) return true;
+        char magic[sizeof(INVENTORY_MAGIC)];
+        if (!in.read(magic, sizeof(magic)) || memcmp(magic, INVENTORY_MAGIC, sizeof(magic)) != 0) {
+            cerr << "Not an inventory file: " << path << endl;
+            return false;
+        }
+        for (int level = 0; level < DIFFICULTY_LEVELS; ++level) {
+            uint32_t count = 0;
+            if (!in.read((char *) &count, sizeof(count))) {
+                cerr << "Truncated inventory file: " << path << endl;
+                return false;
+            }
+            for (uint32_t i = 0; i < count; ++i) {
+                ReadyPuzzle puzzle;
+                in.read((char *) puzzle.cells, KERNEL_CELLS);
+                puzzle.clues = (uint8_t) in.get();
+                puzzle.difficulty = (uint8_t) level;
+                bool valid = (bool) in && clueCount(puzzle.cells) == puzzle.clues &&
+                             all_of(puzzle.cells, puzzle.cells + KERNEL_CELLS, [](uint8_t d) { return d <= KERNEL_SIDE; });
+                if (!valid) {
+                    cerr << "Corrupt inventory file: " << path << endl;
+                    return false;
+                }
+                add(puzzle);
+            }
+        }
+        lock_guard<mutex> lock(mtx);
+        for (int level = 0; level < DIFFICULTY_LEVELS; ++level) {
+            refilling[level] = pools[level].size() < lowWater;
+        }
+        return true;
+    }
+
+private:
+    size_t capacity, lowWater;
+    mutex mtx;
+    condition_variable refill;
+    deque<ReadyPuzzle> pools[DIFFICULTY_LEVELS];
+    bool refilling[DIFFICULTY_LEVELS]; // between falling below the low-water mark and reaching capacity
+    int nextLevel = 0; // where nextRefill starts looking
+    bool stopping = false;
+};
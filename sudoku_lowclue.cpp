@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "sudoku_canonical.cpp"
+#include "sudoku_checkpoint.cpp"
+#include "sudoku_removal.cpp"
+
+using namespace std;
+
+// Search for puzzles with few clues. Every restart takes a new random solution grid and runs an
+// iterated greedy removal on it: the first attempt removes clues from the full grid in a random
+// order until the puzzle is minimal, every further attempt puts a few cells of the solution back
+// into the best puzzle so far and removes again, the clues implied most strongly by the others
+// first. A puzzle that is not worse replaces the best one, so the search can walk along plateaus of
+// equal clue counts. Checkpoints are taken between two solution grids.
+
+struct LowClueSettings {
+    int targetClues = 21; // puzzles with at most this many clues are printed
+    int puzzleCount = 1; // stop after this many distinct puzzles at or below the target
+    double maxSeconds = 60.0; // wall time budget
+    int attemptsPerGrid = 20; // removal attempts before the next solution grid
+    int perturbation = 4; // solution cells added back before every further attempt
+    int threads = 0;
+    unsigned int seed = 1;
+    CheckpointSettings checkpoint;
+};
+
+// Cells set at random before the search completes a variant grid, after the first row
+const int VARIANT_GRID_SEEDS = 10;
+
+// Random solution grid of a variant with extra units, whose diagonal boxes may clash with them: the
+// first row is a random permutation, a few more cells get random candidates under the rules of the
+// variant and the search completes the grid. Seeds without a solution within a small budget are
+// drawn again.
+void randomVariantGrid(uint8_t *board, mt19937 &rng) {
+    TableRules rules(activeVariant);
+    SolveBudget budget;
+    budget.maxNodes = 1000;
+    while (true) {
+        memset(board, 0, KERNEL_CELLS);
+        iota(board, board + KERNEL_SIDE, 1);
+        shuffle(board, board + KERNEL_SIDE, rng);
+        BasicCandidateBoard<TableRules> seeds(board, rules);
+        bool consistent = true;
+        for (int i = 0; i < VARIANT_GRID_SEEDS && consistent; ++i) {
+            int cell;
+            do {
+                cell = uniform_int_distribution<int>(KERNEL_SIDE, KERNEL_CELLS - 1)(rng);
+            } while (seeds.cells[cell] != 0);
+            uint16_t mask = seeds.candidates[cell];
+            if (!mask) {
+                consistent = false;
+                break;
+            }
+            for (int skip = uniform_int_distribution<int>(0, bitCounts.counts[mask] - 1)(rng); skip > 0; --skip) {
+                mask &= (uint16_t) (mask - 1);
+            }
+            consistent = seeds.place(cell, __builtin_ctz(mask));
+        }
+        BasicIterativeSolver<TableRules> solver(seeds.cells, 1, PropagationOptions(), rules);
+        if (searchWithinBudget(solver, budget, solverStats) && solver.solutions() == 1) {
+            memcpy(board, solver.solution(), KERNEL_CELLS);
+            return;
+        }
+    }
+}
+
+// Random solution grid: the three boxes on the diagonal are independent random permutations and
+// the rest is the first solution the search finds
+void randomGrid(uint8_t *board, mt19937 &rng) {
+    if (activeVariant && activeVariant->hasExtraUnits()) {
+        randomVariantGrid(board, rng);
+        return;
+    }
+    memset(board, 0, KERNEL_CELLS);
+    for (int box = 0; box < 3; ++box) {
+        uint8_t digits[KERNEL_SIDE];
+        iota(digits, digits + KERNEL_SIDE, 1);
+        shuffle(digits, digits + KERNEL_SIDE, rng);
+        for (int i = 0; i < KERNEL_SIDE; ++i) {
+            board[(box * 3 + i / 3) * KERNEL_SIDE + box * 3 + i % 3] = digits[i];
+        }
+    }
+    IterativeSolver solver(board, 1, PropagationOptions());
+    solver.resume(-1, solverStats);
+    memcpy(board, solver.solution(), KERNEL_CELLS);
+}
+
+int clueCount(const uint8_t *board) {
+    return (int) count_if(board, board + KERNEL_CELLS, [](uint8_t digit) { return digit != 0; });
+}
+
+// Removal order of an attempt: the clues that the other clues imply most strongly come first, those
+// whose cell would be left with the fewest candidates by its peers. They are the least likely to be
+// load-bearing, so the greedy removal takes them before it gets stuck on clues that pin the solution.
+// Ties, which are all cells of a full grid, stay in random order. The order depends only on the
+// puzzle and rng, so a resumed search draws the same orders.
+template<typename Rules>
+void impliedFirstOrder(const uint8_t *puzzle, vector<int> &order, mt19937 &rng, const Rules &rules) {
+    iota(order.begin(), order.end(), 0);
+    shuffle(order.begin(), order.end(), rng);
+    int freedom[KERNEL_CELLS];
+    for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+        unsigned seen = 0;
+        const uint8_t *peers = rules.peers(cell);
+        for (int i = 0; i < rules.peerCount(cell); ++i) seen |= 1u << puzzle[peers[i]];
+        freedom[cell] = __builtin_popcount(ALL_DIGITS & ~seen);
+    }
+    stable_sort(order.begin(), order.end(), [&freedom](int a, int b) { return freedom[a] < freedom[b]; });
+}
+
+void impliedFirstOrder(const uint8_t *puzzle, vector<int> &order, mt19937 &rng) {
+    if (activeVariant) impliedFirstOrder(puzzle, order, rng, TableRules(activeVariant));
+    else impliedFirstOrder(puzzle, order, rng, ClassicRules());
+}
+
+// Runs the search and prints the puzzles found and the clue count distribution, returns the number
+// of distinct puzzles at or below the target or -1 if the checkpoint cannot be resumed
+int runLowClueSearch(const LowClueSettings &settings) {
+    ParallelRemover remover(settings.threads);
+    mt19937 rng(settings.seed);
+    PuzzleSet found;
+    map<int, int> distribution; // best clue count of every solution grid
+    int grids = 0, attempts = 0, hits = 0;
+    double resumedSeconds = 0.0, resumedCpuSeconds = 0.0;
+    if (settings.checkpoint.resume) {
+        CheckpointReader in;
+        if (!in.open(settings.checkpoint.path, "low-clue")) return -1;
+        in.getEngine(rng);
+        found.loadState(in);
+        uint32_t counts = 0;
+        in.get(counts);
+        for (uint32_t i = 0; i < counts && in.good(); ++i) {
+            int clues = 0;
+            in.get(clues);
+            in.get(distribution[clues]);
+        }
+        in.get(grids);
+        in.get(attempts);
+        in.get(hits);
+        in.get(resumedSeconds);
+        in.get(resumedCpuSeconds);
+        if (!in.ok()) {
+            cerr << "Cannot resume from checkpoint " << settings.checkpoint.path << endl;
+            return -1;
+        }
+        cout << "Resuming after " << grids << " grids, " << hits << " puzzles found" << endl;
+    }
+    CheckpointTimer checkpoints(settings.checkpoint);
+    auto start = chrono::steady_clock::now();
+    clock_t cpuStart = clock();
+    auto elapsed = [&] {
+        return resumedSeconds + chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+    auto cpuSeconds = [&] { return resumedCpuSeconds + (double) (clock() - cpuStart) / CLOCKS_PER_SEC; };
+
+    vector<int> order(KERNEL_CELLS);
+    while (hits < settings.puzzleCount && elapsed() < settings.maxSeconds) {
+        uint8_t solution[KERNEL_CELLS], best[KERNEL_CELLS], puzzle[KERNEL_CELLS];
+        randomGrid(solution, rng);
+        if (activeVariant && activeVariant->hasCages()) activeVariant->setRandomCages(solution, rng);
+        memcpy(best, solution, KERNEL_CELLS);
+        grids++;
+        for (int attempt = 0; attempt < settings.attemptsPerGrid && elapsed() < settings.maxSeconds; ++attempt) {
+            memcpy(puzzle, best, KERNEL_CELLS);
+            if (attempt > 0) {
+                for (int added = 0, tries = 0; added < settings.perturbation && tries < KERNEL_CELLS; ++tries) {
+                    int cell = uniform_int_distribution<int>(0, KERNEL_CELLS - 1)(rng);
+                    if (puzzle[cell] != 0) continue;
+                    puzzle[cell] = solution[cell];
+                    added++;
+                }
+            }
+            impliedFirstOrder(puzzle, order, rng);
+            remover.removeClues(puzzle, KERNEL_CELLS, &order);
+            attempts++;
+            if (clueCount(puzzle) <= clueCount(best)) memcpy(best, puzzle, KERNEL_CELLS);
+            if (clueCount(best) <= settings.targetClues) break;
+        }
+        int clues = clueCount(best);
+        distribution[clues]++;
+        if (clues <= settings.targetClues && found.insert(best)) {
+            hits++;
+            cout << clues << " clues: ";
+            for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+                cout << (int) best[cell];
+            }
+            if (activeVariant && activeVariant->hasCages()) cout << " cages " << activeVariant->describeCages();
+            cout << endl;
+        }
+
+        if (checkpoints.due()) {
+            CheckpointWriter out("low-clue");
+            out.putEngine(rng);
+            found.saveState(out);
+            out.put((uint32_t) distribution.size());
+            for (const auto &entry: distribution) {
+                out.put(entry.first);
+                out.put(entry.second);
+            }
+            out.put(grids);
+            out.put(attempts);
+            out.put(hits);
+            out.put(elapsed());
+            out.put(cpuSeconds());
+            out.commit(checkpoints.path());
+        }
+    }
+    // The search is complete, a later resume must not continue it
+    if (!settings.checkpoint.path.empty()) remove(settings.checkpoint.path.c_str());
+
+    double seconds = elapsed();
+    double cpuHours = cpuSeconds() / 3600.0;
+    cout << "Low-clue search: " << grids << " grids, " << attempts << " attempts, " << seconds << " s, "
+         << cpuHours * 3600.0 << " CPU s" << endl;
+    cout << "Clues  Grids  Per CPU-hour" << endl;
+    for (const auto &entry: distribution) {
+        cout << setw(5) << entry.first << "  " << setw(5) << entry.second << "  " << setw(12) << fixed
+             << setprecision(1) << (cpuHours > 0 ? entry.second / cpuHours : 0.0) << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    return hits;
+}
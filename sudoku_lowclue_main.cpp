@@ -0,0 +1,85 @@
+#include <ctime>
+#include <string>
+#include <vector>
+#include "sudoku_lowclue.cpp"
+#include "sudoku_options.cpp"
+
+using namespace std;
+
+// The low-clue search (see sudoku_lowclue.cpp) as a program of its own, built on sudoku_core
+// without GAlib
+
+struct LowClueConfig {
+    string variant = "classic"; // extra units or cages of the puzzles, see sudoku_variant.cpp
+    int targetClues = 21;
+    int puzzleCount = 1;
+    float timeBudget = 60.0; // seconds
+    int attempts = 20;
+    int perturbation = 4;
+    int threads = 0; // 0 = one per hardware thread
+    SolverConfig solver;
+    string checkpointPath; // see sudoku_checkpoint.cpp
+    float checkpointInterval = 300.0; // seconds
+    bool resume = false; // continue from checkpointPath
+    int seed = 0; // 0 seeds from the current time
+};
+
+vector<ConfigOption> configOptions(LowClueConfig &config) {
+    vector<ConfigOption> options = {
+            {"variant",               CONFIG_TEXT,  &config.variant,            "puzzle variant, classic, x, windoku or killer"},
+            {"target-clues",          CONFIG_INT,   &config.targetClues,        "clue count target"},
+            {"puzzles",               CONFIG_INT,   &config.puzzleCount,        "distinct puzzles at or below the target to find"},
+            {"time-budget",           CONFIG_FLOAT, &config.timeBudget,         "search time in seconds"},
+            {"low-clue-attempts",     CONFIG_INT,   &config.attempts,           "removal attempts per solution grid"},
+            {"low-clue-perturbation", CONFIG_INT,   &config.perturbation,       "clues added back between attempts"},
+            {"threads",               CONFIG_INT,   &config.threads,            "worker threads, 0 = one per hardware thread"},
+            {"checkpoint",            CONFIG_TEXT,  &config.checkpointPath,     "snapshot file of the search"},
+            {"checkpoint-interval",   CONFIG_FLOAT, &config.checkpointInterval, "seconds between snapshots"},
+            {"resume",                CONFIG_FLAG,  &config.resume,             "continue the search saved in the checkpoint file"},
+            {"seed",                  CONFIG_INT,   &config.seed,               "random seed, 0 seeds from the current time"},
+    };
+    addSolverOptions(options, config.solver);
+    return options;
+}
+
+bool validateConfig(const LowClueConfig &config) {
+    vector<string> errors;
+    if (!isVariant(config.variant)) errors.push_back(string("variant must be ") + VARIANTS);
+    // 17 is the fewest clues of a unique classic sudoku, Killer puzzles often have none
+    if (config.variant == "classic" && (config.targetClues < 17 || config.targetClues > 81))
+        errors.push_back("target-clues must be between 17 and 81");
+    if (config.variant != "classic" && (config.targetClues < 0 || config.targetClues > 81))
+        errors.push_back("target-clues must be between 0 and 81");
+    if (config.puzzleCount < 1) errors.push_back("puzzles must be at least 1");
+    if (config.timeBudget <= 0) errors.push_back("time-budget must be positive");
+    if (config.attempts < 1) errors.push_back("low-clue-attempts must be at least 1");
+    if (config.perturbation < 0) errors.push_back("low-clue-perturbation must not be negative");
+    if (config.threads < 0) errors.push_back("threads must not be negative");
+    validateSolverConfig(config.solver, errors);
+    if (config.checkpointInterval <= 0) errors.push_back("checkpoint-interval must be positive");
+    if (config.resume && config.checkpointPath.empty()) errors.push_back("resume needs a checkpoint file");
+    if (config.seed < 0) errors.push_back("seed must not be negative");
+    return reportConfigErrors(errors);
+}
+
+int main(int argc, char **argv) {
+    LowClueConfig config;
+    if (!parseArguments(argc, argv, config)) return 1;
+
+    applySolverConfig(config.solver);
+    ConstraintTable variant(config.variant);
+    if (config.variant != "classic") activeVariant = &variant;
+
+    LowClueSettings settings;
+    settings.targetClues = config.targetClues;
+    settings.puzzleCount = config.puzzleCount;
+    settings.maxSeconds = config.timeBudget;
+    settings.attemptsPerGrid = config.attempts;
+    settings.perturbation = config.perturbation;
+    settings.threads = config.threads;
+    settings.seed = config.seed ? (unsigned int) config.seed : static_cast<unsigned int>(time(nullptr));
+    settings.checkpoint.path = config.checkpointPath;
+    settings.checkpoint.interval = config.checkpointInterval;
+    settings.checkpoint.resume = config.resume;
+    return runLowClueSearch(settings) >= 0 ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "sudoku_search.h"
+
+using namespace std;
+
+// Command line flags and config files of the programs. A program describes its settings with a
+// configuration struct, a configOptions function listing the options bound to its fields and a
+// validateConfig function; the templates below parse "--name value", "--name=value" and
+// "name = value" lines of a config file for any of them.
+
+enum ConfigType {
+    CONFIG_INT, CONFIG_FLOAT, CONFIG_FLAG, CONFIG_TEXT
+};
+
+struct ConfigOption {
+    const char *name;
+    ConfigType type;
+    void *field;
+    const char *help;
+};
+
+// Settings of the solver calls, shared by all programs
+struct SolverConfig {
+    bool propagation = true; // constraint propagation in the solver, false uses the plain recursion
+    bool lockedCandidates = false;
+    int nodeBudget = 0; // per solver call, 0 = no limit
+    float timeBudget = 0.0; // seconds per solver call, 0 = no limit
+};
+
+void addSolverOptions(vector<ConfigOption> &options, SolverConfig &solver) {
+    options.insert(options.end(), {
+            {"propagation",        CONFIG_FLAG,  &solver.propagation,      "solve with constraint propagation (--propagation=false for plain backtracking)"},
+            {"locked-candidates",  CONFIG_FLAG,  &solver.lockedCandidates, "add locked candidates to the propagation"},
+            {"solver-node-budget", CONFIG_INT,   &solver.nodeBudget,       "search nodes per solver call, 0 = no limit"},
+            {"solver-time-budget", CONFIG_FLOAT, &solver.timeBudget,       "seconds per solver call, 0 = no limit"},
+    });
+}
+
+void validateSolverConfig(const SolverConfig &solver, vector<string> &errors) {
+    if (solver.nodeBudget < 0) errors.push_back("solver-node-budget must not be negative");
+    if (solver.timeBudget < 0) errors.push_back("solver-time-budget must not be negative");
+}
+
+// Set the options of the solver calls of the program
+void applySolverConfig(const SolverConfig &solver) {
+    propagationOptions.enabled = solver.propagation;
+    propagationOptions.lockedCandidates = solver.lockedCandidates;
+    solveBudget.maxNodes = solver.nodeBudget;
+    solveBudget.maxSeconds = solver.timeBudget;
+}
+
+// Print the errors collected by a validateConfig, returns true if there are none
+bool reportConfigErrors(const vector<string> &errors) {
+    for (const string &error: errors) {
+        cerr << "Invalid configuration: " << error << endl;
+    }
+    return errors.empty();
+}
+
+// Set the option called name, returns false if there is no such option or the value does not parse
+template<typename Config>
+bool setConfigValue(Config &config, const string &name, const string &value) {
+    for (const ConfigOption &option: configOptions(config)) {
+        if (name != option.name) continue;
+        const char *text = value.c_str();
+        char *end = nullptr;
+        switch (option.type) {
+            case CONFIG_INT:
+                *(int *) option.field = (int) strtol(text, &end, 10);
+                break;
+            case CONFIG_FLOAT:
+                *(float *) option.field = strtof(text, &end);
+                break;
+            case CONFIG_FLAG:
+                if (value == "true" || value == "1") *(bool *) option.field = true;
+                else if (value == "false" || value == "0") *(bool *) option.field = false;
+                else break;
+                return true;
+            case CONFIG_TEXT:
+                *(string *) option.field = value;
+                return true;
+        }
+        if (end == text || *end != '\0') break;
+        return true;
+    }
+    cerr << "Invalid option " << name << " = " << value << endl;
+    return false;
+}
+
+// Read "name = value" lines, empty lines and lines starting with # are skipped
+template<typename Config>
+bool loadConfigFile(const string &path, Config &config) {
+    ifstream in(path);
+    if (!in) {
+        cerr << "Cannot open config file " << path << endl;
+        return false;
+    }
+    string line;
+    int lineNumber = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == string::npos || line[first] == '#') continue;
+        size_t equals = line.find('=');
+        if (equals == string::npos) {
+            cerr << path << ":" << lineNumber << ": expected name = value" << endl;
+            return false;
+        }
+        size_t nameEnd = line.find_last_not_of(" \t", equals - 1);
+        size_t valueStart = line.find_first_not_of(" \t", equals + 1);
+        size_t valueEnd = line.find_last_not_of(" \t\r");
+        string name = line.substr(first, nameEnd == string::npos || nameEnd < first ? 0 : nameEnd - first + 1);
+        string value = valueStart == string::npos || valueStart > valueEnd ? "" : line.substr(valueStart, valueEnd - valueStart + 1);
+        if (!setConfigValue(config, name, value)) return false;
+    }
+    return true;
+}
+
+template<typename Config>
+void printUsage(const char *program) {
+    Config defaults;
+    cerr << "Usage: " << program << " [--config FILE] [--name value | --name=value]..." << endl;
+    cerr << "Options (also accepted as name = value lines in the config file):" << endl;
+    for (const ConfigOption &option: configOptions(defaults)) {
+        cerr << "  --" << option.name << "  " << option.help;
+        switch (option.type) {
+            case CONFIG_INT:
+                cerr << " (default " << *(int *) option.field << ")";
+                break;
+            case CONFIG_FLOAT:
+                cerr << " (default " << *(float *) option.field << ")";
+                break;
+            default:
+                break;
+        }
+        cerr << endl;
+    }
+}
+
+// Parse the command line, options are applied in order so flags after --config override the file
+template<typename Config>
+bool parseArguments(int argc, char **argv, Config &config) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            printUsage<Config>(argv[0]);
+            return false;
+        }
+        string name = arg.substr(2);
+        string value;
+        size_t equals = name.find('=');
+        bool isFlag = false;
+        for (const ConfigOption &option: configOptions(config)) {
+            if (name == option.name && option.type == CONFIG_FLAG) isFlag = true;
+        }
+        if (equals != string::npos) {
+            value = name.substr(equals + 1);
+            name = name.substr(0, equals);
+        } else if (isFlag) {
+            value = "true";
+        } else if (i + 1 < argc) {
+            value = argv[++i];
+        } else {
+            printUsage<Config>(argv[0]);
+            return false;
+        }
+        if (name == "help") {
+            printUsage<Config>(argv[0]);
+            return false;
+        }
+        bool ok = name == "config" ? loadConfigFile(value, config) : setConfigValue(config, name, value);
+        if (!ok) return false;
+    }
+    return validateConfig(config);
+}
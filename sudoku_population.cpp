@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "sudoku_solver.h"
+
+using namespace std;
+
+// Native population storage: the genes of all individuals in one contiguous slab of bytes
+// (81 per individual, one cell per byte) and their fitness in a parallel array. The operators
+// below work on one packed board, so evaluation and variation stream linearly through the slab.
+
+const int GENOME_LENGTH = GRID_SIDE * GRID_SIDE;
+
+class Population {
+public:
+    explicit Population(int size = 0) {
+        resize(size);
+    }
+
+    // Keeps the first min(size, newSize) individuals, new individuals are zeroed
+    void resize(int newSize) {
+        slab.resize((size_t) newSize * GENOME_LENGTH);
+        scores.resize(newSize);
+        count = newSize;
+    }
+
+    int size() const {
+        return count;
+    }
+
+    uint8_t *genes(int individual) {
+        return slab.data() + (size_t) individual * GENOME_LENGTH;
+    }
+
+    const uint8_t *genes(int individual) const {
+        return slab.data() + (size_t) individual * GENOME_LENGTH;
+    }
+
+    float &fitness(int individual) {
+        return scores[individual];
+    }
+
+    float fitness(int individual) const {
+        return scores[individual];
+    }
+
+    void copyIndividual(int to, const Population &from, int individual) {
+        memcpy(genes(to), from.genes(individual), GENOME_LENGTH);
+        scores[to] = from.scores[individual];
+    }
+
+    void swap(Population &other) {
+        slab.swap(other.slab);
+        scores.swap(other.scores);
+        std::swap(count, other.count);
+    }
+
+private:
+    vector<uint8_t> slab;
+    vector<float> scores;
+    int count = 0;
+};
+
+// Fitness of a packed board, 2 * GRID_SIDE^3 for a valid sudoku, else GRID_SIDE^3 minus the repetitions
+float fitnessFromRepetitions(const uint8_t *board, int repetitions) {
+    if (repetitions == 0 && memchr(board, 0, GENOME_LENGTH) == nullptr) {
+        return GRID_SIDE * GRID_SIDE * GRID_SIDE * 2;
+    }
+    return (float) (GRID_SIDE * GRID_SIDE * GRID_SIDE - repetitions);
+}
+
+float boardObjective(const uint8_t *board) {
+    return fitnessFromRepetitions(board, boardRepetitions(board) + variantRepetitions(board));
+}
+
+// Fitness of `count` packed boards stored back to back. The boards go through the batch
+// conflict kernel in chunks, so that the SIMD kernels see full tiles and a linear stream.
+void evaluateBoards(const uint8_t *boards, int count, float *fitness) {
+    const int chunk = 256;
+    int repetitions[chunk];
+    for (int first = 0; first < count; first += chunk) {
+        int n = min(chunk, count - first);
+        const uint8_t *batch = boards + (size_t) first * GENOME_LENGTH;
+        boardRepetitionsBatch(batch, n, repetitions);
+        for (int i = 0; i < n; ++i) {
+            const uint8_t *board = batch + (size_t) i * GENOME_LENGTH;
+            fitness[first + i] = fitnessFromRepetitions(board, repetitions[i] + variantRepetitions(board));
+        }
+    }
+}
+
+// Score the individuals [begin, end) of a population
+void evaluatePopulation(Population &population, int begin, int end) {
+    if (end > begin) evaluateBoards(population.genes(begin), end - begin, &population.fitness(begin));
+}
+
+// 64-bit hash of a packed board, read as ten 8-byte words plus the last cell
+uint64_t boardHash(const uint8_t *board) {
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+    uint64_t hash = 0x243F6A8885A308D3ull;
+    for (int i = 0; i + 8 <= GENOME_LENGTH; i += 8) {
+        uint64_t word;
+        memcpy(&word, board + i, 8);
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 29;
+    }
+    hash = (hash ^ board[GENOME_LENGTH - 1]) * multiplier;
+    hash ^= hash >> 32;
+    return hash != 0 ? hash : 1; // 0 marks an empty cache slot
+}
+
+// Direct-mapped cache of fitness values keyed by board hash. Most children of a generation are
+// unchanged copies of a parent, so their fitness is looked up instead of recomputed.
+// A hit is trusted on the full 64-bit hash, the chance of a wrong score is about 2^-64 per lookup.
+class FitnessCache {
+public:
+    long long hits = 0;
+    long long misses = 0;
+
+    // Grow to at least twice the given number of entries, so that a whole population fits
+    void reserve(int entries) {
+        size_t capacity = 1024;
+        while (capacity < (size_t) entries * 2) capacity *= 2;
+        if (capacity > slots.size()) {
+            slots.assign(capacity, Slot());
+        }
+    }
+
+    bool lookup(uint64_t hash, float &fitness) {
+        if (slots.empty()) return false;
+        const Slot &slot = slots[hash & (slots.size() - 1)];
+        if (slot.hash != hash) return false;
+        fitness = slot.fitness;
+        return true;
+    }
+
+    void insert(uint64_t hash, float fitness) {
+        if (slots.empty()) reserve(0);
+        Slot &slot = slots[hash & (slots.size() - 1)];
+        slot.hash = hash;
+        slot.fitness = fitness;
+    }
+
+    double hitRate() const {
+        return hits + misses > 0 ? (double) hits / (double) (hits + misses) : 0.0;
+    }
+
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        float fitness = 0.0f;
+    };
+    vector<Slot> slots;
+};
+
+// Score the individuals [begin, end) of a population, only boards missing from the cache are evaluated.
+// Returns the number of boards that were evaluated.
+int evaluatePopulationCached(Population &population, int begin, int end, FitnessCache &cache) {
+    thread_local Population misses;
+    thread_local vector<int> missIndex;
+    thread_local vector<uint64_t> missHash;
+    cache.reserve(end - begin);
+    misses.resize(end - begin);
+    missIndex.clear();
+    missHash.clear();
+    for (int i = begin; i < end; ++i) {
+        uint64_t hash = boardHash(population.genes(i));
+        if (cache.lookup(hash, population.fitness(i))) continue;
+        memcpy(misses.genes((int) missIndex.size()), population.genes(i), GENOME_LENGTH);
+        missIndex.push_back(i);
+        missHash.push_back(hash);
+    }
+    int evaluated = (int) missIndex.size();
+    cache.hits += (end - begin) - evaluated;
+    cache.misses += evaluated;
+    evaluatePopulation(misses, 0, evaluated);
+    for (int k = 0; k < evaluated; ++k) {
+        population.fitness(missIndex[k]) = misses.fitness(k);
+        cache.insert(missHash[k], misses.fitness(k));
+    }
+    return evaluated;
+}
+
+// Fill the diagonal boxes with shuffled digits and every other cell with a digit missing from its row
+void initializeBoard(uint8_t *board, mt19937 &rng) {
+    memset(board, 0, GENOME_LENGTH);
+    for (int box = 0; box < 3; ++box) {
+        uint8_t boxValues[GRID_SIDE];
+        for (int i = 0; i < GRID_SIDE; ++i) {
+            boxValues[i] = (uint8_t) (i + 1);
+        }
+        shuffle(boxValues, boxValues + GRID_SIDE, rng);
+        for (int row = 0; row < 3; ++row) {
+            for (int col = 0; col < 3; ++col) {
+                board[(box * 3 + row) * GRID_SIDE + box * 3 + col] = boxValues[row * 3 + col];
+            }
+        }
+    }
+    for (int row = 0; row < GRID_SIDE; ++row) {
+        unsigned present = 0;
+        for (int col = 0; col < GRID_SIDE; ++col) {
+            present |= 1u << board[row * GRID_SIDE + col];
+        }
+        for (int col = 0; col < GRID_SIDE; ++col) {
+            if (board[row * GRID_SIDE + col] != 0) continue;
+            uint8_t randomValues[GRID_SIDE];
+            for (int i = 0; i < GRID_SIDE; ++i) {
+                randomValues[i] = (uint8_t) (i + 1);
+            }
+            shuffle(randomValues, randomValues + GRID_SIDE, rng);
+            for (int i = 0; i < GRID_SIDE; ++i) {
+                if (!(present & (1u << randomValues[i]))) {
+                    board[row * GRID_SIDE + col] = randomValues[i];
+                    present |= 1u << randomValues[i];
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Swap two different random cells with probability p, returns the number of mutations
+int mutateBoard(uint8_t *board, float p, mt19937 &rng) {
+    if (uniform_real_distribution<float>(0.0f, 1.0f)(rng) >= p) return 0;
+    uniform_int_distribution<int> position(0, GENOME_LENGTH - 1);
+    int pos1 = position(rng);
+    int pos2 = position(rng);
+    while (pos2 == pos1) {
+        pos2 = position(rng);
+    }
+    swap(board[pos1], board[pos2]);
+    return 1;
+}
+
+// One-point crossover at the end of row 3 or 6, returns the number of children
+int crossoverBoards(const uint8_t *parent1, const uint8_t *parent2, uint8_t *child1, uint8_t *child2, mt19937 &rng) {
+    int cut = (uniform_int_distribution<int>(1, 2)(rng)) * 3 * GRID_SIDE;
+    memcpy(child1, parent1, cut);
+    memcpy(child1 + cut, parent2 + cut, GENOME_LENGTH - cut);
+    memcpy(child2, parent2, cut);
+    memcpy(child2 + cut, parent1 + cut, GENOME_LENGTH - cut);
+    return 2;
+}
+
+// Diversity of the population as reported by the telemetry: the fraction of individuals that differ
+// from the most common value of a cell, averaged over all cells (0 when all individuals are equal)
+float populationDiversity(const Population &population) {
+    int size = population.size();
+    if (size == 0) return 0.0f;
+    vector<int> counts(GENOME_LENGTH * (GRID_SIDE + 1), 0);
+    for (int i = 0; i < size; ++i) {
+        const uint8_t *board = population.genes(i);
+        for (int cell = 0; cell < GENOME_LENGTH; ++cell) {
+            counts[cell * (GRID_SIDE + 1) + board[cell]]++;
+        }
+    }
+    long long differing = 0;
+    for (int cell = 0; cell < GENOME_LENGTH; ++cell) {
+        differing += size - *max_element(counts.begin() + cell * (GRID_SIDE + 1),
+                                         counts.begin() + (cell + 1) * (GRID_SIDE + 1));
+    }
+    return (float) differing / (float) (GENOME_LENGTH * size);
+}
@@ -0,0 +1,37 @@
+#include "sudoku_propagation.h"
+
+using namespace std;
+
+PropagationTables::PropagationTables() : peers(), intersection(), lineRest(), boxRest() {
+    for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+        int count = 0;
+        for (int other = 0; other < KERNEL_CELLS; ++other) {
+            if (other != cell && (sameRow(cell, other) || sameColumn(cell, other) || sameBox(cell, other))) {
+                peers[cell][count++] = (uint8_t) other;
+            }
+        }
+    }
+    int index = 0;
+    for (int line = 0; line < 2 * KERNEL_SIDE; ++line) {
+        for (int third = 0; third < 3; ++third, ++index) {
+            // The box that holds cells 3 * third .. 3 * third + 2 of the line
+            int box = line < KERNEL_SIDE ? (line / 3) * 3 + third : third * 3 + (line - KERNEL_SIDE) / 3;
+            int inBoth = 0, onlyLine = 0, onlyBox = 0;
+            for (int i = 0; i < KERNEL_SIDE; ++i) {
+                uint8_t lineCell = unitCell(line, i);
+                uint8_t boxCell = unitCell(2 * KERNEL_SIDE + box, i);
+                if (boxOf(lineCell) == box) intersection[index][inBoth++] = lineCell;
+                else lineRest[index][onlyLine++] = lineCell;
+                bool inLine = line < KERNEL_SIDE ? boxCell / KERNEL_SIDE == line : boxCell % KERNEL_SIDE == line - KERNEL_SIDE;
+                if (!inLine) boxRest[index][onlyBox++] = boxCell;
+            }
+        }
+    }
+}
+
+// The tables are built from unitCell, not from unitCells, which may be initialized after them
+const PropagationTables propagationTables;
+
+PropagationOptions propagationOptions;
+
+thread_local SolverStats solverStats;
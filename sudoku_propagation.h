@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include "sudoku_simd.h"
+
+// Constraint propagation for the solver. Every empty cell keeps a mask of the digits (bits 1-9)
+// that do not occur among its peers. Naked singles (a cell with one candidate), hidden singles
+// (a digit with one place in a unit) and optionally locked candidates (a digit of a box confined
+// to one line, or of a line confined to one box) are applied until nothing changes. The search
+// only guesses when propagation is stuck, on the cell with the fewest candidates.
+
+const uint16_t ALL_DIGITS = 0x3FE;
+
+// The 20 peers of every cell and, for locked candidates, the 54 line/box intersections
+struct PropagationTables {
+    uint8_t peers[KERNEL_CELLS][20];
+    uint8_t intersection[2 * KERNEL_SIDE * 3][3]; // cells in both the line and the box
+    uint8_t lineRest[2 * KERNEL_SIDE * 3][6]; // cells of the line outside the box
+    uint8_t boxRest[2 * KERNEL_SIDE * 3][6]; // cells of the box outside the line
+
+    PropagationTables();
+
+    static bool sameRow(int a, int b) { return a / KERNEL_SIDE == b / KERNEL_SIDE; }
+
+    static bool sameColumn(int a, int b) { return a % KERNEL_SIDE == b % KERNEL_SIDE; }
+
+    static int boxOf(int cell) { return (cell / KERNEL_SIDE / 3) * 3 + cell % KERNEL_SIDE / 3; }
+
+    static bool sameBox(int a, int b) { return boxOf(a) == boxOf(b); }
+};
+
+extern const PropagationTables propagationTables;
+
+struct PropagationOptions {
+    bool enabled = true; // false solves with the plain recursion, for comparison
+    bool hiddenSingles = true;
+    bool lockedCandidates = false;
+};
+
+// Options of the solver calls of the generator
+extern PropagationOptions propagationOptions;
+
+// How much of the solving was done by propagation and how much by search
+struct SolverStats {
+    long long calls = 0;
+    long long emptyCells = 0; // empty cells of the solved grids
+    long long nakedSingles = 0;
+    long long hiddenSingles = 0;
+    long long lockedEliminations = 0; // candidates removed by locked candidates
+    long long guesses = 0; // cells set by the search
+    long long contradictions = 0; // dead ends found by propagation
+    long long nodes = 0; // boards propagated by the search
+    long long budgetExhaustions = 0; // calls stopped by their node or time budget
+
+    void add(const SolverStats &other) {
+        calls += other.calls;
+        emptyCells += other.emptyCells;
+        nakedSingles += other.nakedSingles;
+        hiddenSingles += other.hiddenSingles;
+        lockedEliminations += other.lockedEliminations;
+        guesses += other.guesses;
+        contradictions += other.contradictions;
+        nodes += other.nodes;
+        budgetExhaustions += other.budgetExhaustions;
+    }
+
+    // Share of the cells filled by propagation instead of guesses
+    double propagatedShare() const {
+        long long filled = nakedSingles + hiddenSingles;
+        return filled + guesses > 0 ? (double) filled / (double) (filled + guesses) : 0.0;
+    }
+};
+
+extern thread_local SolverStats solverStats;
+
+// Units and peers of the classic grid, fixed so the classic solver compiles against constant tables.
+// The boards and the solver take their rules as a template parameter; variants use TableRules
+// (sudoku_variant.cpp), which reads them from a ConstraintTable.
+struct ClassicRules {
+    int peerCount(int) const { return 20; }
+
+    const uint8_t *peers(int cell) const { return propagationTables.peers[cell]; }
+
+    int unitCount() const { return KERNEL_UNITS; }
+
+    const uint8_t *unit(int index) const { return unitCells.cells[index]; }
+
+    // Deductions beyond singles and locked candidates, false on a contradiction; none here
+    template<typename Board>
+    bool prune(Board &, bool &) const { return true; }
+};
+
+// Board with the candidates of its empty cells
+template<typename Rules>
+struct BasicCandidateBoard {
+    uint8_t cells[KERNEL_CELLS];
+    uint16_t candidates[KERNEL_CELLS];
+    int empty;
+    Rules rules;
+
+    // Candidates of the empty cells come from the digits of their peers, givens are not checked
+    // against each other
+    explicit BasicCandidateBoard(const uint8_t *board, const Rules &rules = Rules()) : empty(0), rules(rules) {
+        memcpy(cells, board, KERNEL_CELLS);
+        for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+            candidates[cell] = 0;
+            if (cells[cell] != 0) continue;
+            uint16_t used = 0;
+            const uint8_t *peers = rules.peers(cell);
+            for (int i = 0; i < rules.peerCount(cell); ++i) {
+                used |= (uint16_t) (1u << cells[peers[i]]);
+            }
+            candidates[cell] = (uint16_t) (ALL_DIGITS & ~used);
+            empty++;
+        }
+    }
+
+    // Set a digit and remove it from the candidates of the peers, false if a peer is left without one
+    bool place(int cell, int digit) {
+        cells[cell] = (uint8_t) digit;
+        candidates[cell] = 0;
+        empty--;
+        uint16_t bit = (uint16_t) (1u << digit);
+        bool consistent = true;
+        const uint8_t *peers = rules.peers(cell);
+        for (int i = 0; i < rules.peerCount(cell); ++i) {
+            uint8_t peer = peers[i];
+            if (cells[peer] != 0 || !(candidates[peer] & bit)) continue;
+            candidates[peer] &= (uint16_t) ~bit;
+            if (candidates[peer] == 0) consistent = false;
+        }
+        return consistent;
+    }
+
+    // Remove candidates from an empty cell, false if none is left
+    bool eliminate(int cell, uint16_t mask) {
+        candidates[cell] &= (uint16_t) ~mask;
+        return candidates[cell] != 0;
+    }
+};
+
+typedef BasicCandidateBoard<ClassicRules> CandidateBoard;
+
+// Apply the rules to a fixpoint, false on a contradiction. Board is a BasicCandidateBoard or a type
+// with the same members that records its changes; its rules give the units and any extra pruning.
+template<typename Board>
+bool propagate(Board &board, const PropagationOptions &options, SolverStats &stats) {
+    bool changed = true;
+    while (changed && board.empty > 0) {
+        changed = false;
+        for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+            if (board.cells[cell] != 0) continue;
+            uint16_t mask = board.candidates[cell];
+            if (mask == 0) return false;
+            if (mask & (mask - 1)) continue;
+            stats.nakedSingles++;
+            if (!board.place(cell, __builtin_ctz(mask))) return false;
+            changed = true;
+        }
+        for (int unit = 0; unit < board.rules.unitCount() && options.hiddenSingles; ++unit) {
+            const uint8_t *cells = board.rules.unit(unit);
+            uint16_t once = 0, twice = 0, placed = 0;
+            for (int i = 0; i < KERNEL_SIDE; ++i) {
+                uint8_t cell = cells[i];
+                uint16_t mask = board.candidates[cell];
+                twice |= once & mask;
+                once |= mask;
+                placed |= (uint16_t) (1u << board.cells[cell]);
+            }
+            if (((once | placed) & ALL_DIGITS) != ALL_DIGITS) return false;
+            uint16_t hidden = once & ~twice & ~placed;
+            while (hidden) {
+                int digit = __builtin_ctz(hidden);
+                hidden &= (uint16_t) (hidden - 1);
+                for (int i = 0; i < KERNEL_SIDE; ++i) {
+                    uint8_t cell = cells[i];
+                    if (board.cells[cell] != 0 || !(board.candidates[cell] & (1u << digit))) continue;
+                    stats.hiddenSingles++;
+                    if (!board.place(cell, digit)) return false;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+        if (!board.rules.prune(board, changed)) return false;
+        if (changed || !options.lockedCandidates) continue;
+        for (int i = 0; i < 2 * KERNEL_SIDE * 3; ++i) {
+            uint16_t inBoth = 0, onlyLine = 0, onlyBox = 0;
+            for (uint8_t cell: propagationTables.intersection[i]) inBoth |= board.candidates[cell];
+            for (uint8_t cell: propagationTables.lineRest[i]) onlyLine |= board.candidates[cell];
+            for (uint8_t cell: propagationTables.boxRest[i]) onlyBox |= board.candidates[cell];
+            // Confined to the intersection in the box: drop from the rest of the line, and vice versa
+            uint16_t pointing = inBoth & ~onlyBox & onlyLine;
+            uint16_t claiming = inBoth & ~onlyLine & onlyBox;
+            if (!(pointing | claiming)) continue;
+            for (uint8_t cell: propagationTables.lineRest[i]) {
+                uint16_t removed = board.candidates[cell] & pointing;
+                if (!removed) continue;
+                stats.lockedEliminations += bitCounts.counts[removed];
+                if (!board.eliminate(cell, removed)) return false;
+            }
+            for (uint8_t cell: propagationTables.boxRest[i]) {
+                uint16_t removed = board.candidates[cell] & claiming;
+                if (!removed) continue;
+                stats.lockedEliminations += bitCounts.counts[removed];
+                if (!board.eliminate(cell, removed)) return false;
+            }
+            changed = true;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "sudoku_search.h"
+#include "sudoku_threads.cpp"
+
+using namespace std;
+
+// Clue removal on packed boards with the uniqueness checks spread over worker threads.
+//
+// Removal is greedy in a fixed order of the cells: a clue is removed if the puzzle stays unique
+// without it. Removing clues only adds solutions, so a clue that cannot be removed from a clue set
+// cannot be removed from any subset either. The workers test a window of pending clues in two phases:
+//  1. every clue of the window against the current clue set; rejected clues are final,
+//  2. every accepted clue against the current clue set minus the accepted clues before it.
+// The driver commits the accepted clues in order up to the first one that fails phase 2, which is
+// dropped, and puts the ones after it back in front of the pending clues to be re-validated.
+// This gives the same puzzle as testing the clues one after another, for any number of threads.
+
+// Pending clues tested per worker and round
+const int REMOVAL_WINDOW_PER_WORKER = 4;
+
+class ParallelRemover {
+public:
+    // threads = 0 uses one worker per hardware thread
+    explicit ParallelRemover(int threads = 0) : pool(threads), workerStats(pool.size()) {}
+
+    // Remove clues until the board has maxEmpty empty cells or no clue can be removed, returns the
+    // number of empty cells. The clues are tried in row-major order or in the order of the cells in
+    // order. Solver calls that run out of budget keep their clue.
+    int removeClues(uint8_t *board, int maxEmpty, const vector<int> *order = nullptr) {
+        vector<int> pending;
+        int empty = 0;
+        for (int i = 0; i < KERNEL_CELLS; ++i) {
+            int cell = order ? (*order)[i] : i;
+            if (board[cell] != 0) pending.push_back(cell);
+            else empty++;
+        }
+        while (!pending.empty() && empty < maxEmpty) {
+            int window = min((int) pending.size(), REMOVAL_WINDOW_PER_WORKER * pool.size());
+            vector<int> tested(pending.begin(), pending.begin() + window);
+            testRemovals(board, tested, false);
+            vector<int> accepted;
+            for (int i = 0; i < window; ++i) {
+                if (results[i]) accepted.push_back(tested[i]);
+            }
+            int committed = 0;
+            if (accepted.size() > 1) testRemovals(board, accepted, true);
+            while (committed < (int) accepted.size() && empty < maxEmpty && (committed == 0 || results[committed])) {
+                board[accepted[committed++]] = 0;
+                empty++;
+            }
+            // The first accepted clue that failed phase 2 stays, the ones after it are tested again
+            int retested = committed < (int) accepted.size() && empty < maxEmpty ? committed + 1 : committed;
+            vector<int> next(accepted.begin() + retested, accepted.end());
+            next.insert(next.end(), pending.begin() + window, pending.end());
+            pending.swap(next);
+        }
+        return empty;
+    }
+
+    // A puzzle is minimal if it is unique and no clue can be removed. The clues are tested in
+    // parallel against the solution: a clue is removable unless the puzzle without it has a solution
+    // with another digit in its cell, which a search stops looking for at the first one. Solver calls
+    // that run out of budget make the result false.
+    bool isMinimal(const uint8_t *board) {
+        if (activeVariant) return isMinimal(board, TableRules(activeVariant));
+        return isMinimal(board, ClassicRules());
+    }
+
+    // Number of solutions of the puzzle without each of its clues, capped at cap: counts[cell] is 0 for
+    // the empty cells and -1 when the solver ran out of budget. For a unique puzzle the workers share
+    // its solution and only count the solutions with another digit in the removed cell.
+    void removalSolutionCounts(const uint8_t *board, int cap, vector<int> &counts) {
+        if (activeVariant) removalSolutionCounts(board, cap, counts, TableRules(activeVariant));
+        else removalSolutionCounts(board, cap, counts, ClassicRules());
+    }
+
+    int size() const {
+        return pool.size();
+    }
+
+private:
+    // The solver calls of the public methods under the rules of the active variant
+    template<typename Rules>
+    bool isMinimal(const uint8_t *board, const Rules &rules) {
+        BasicIterativeSolver<Rules> solver(board, 2, propagationOptions, rules);
+        if (!searchWithinBudget(solver, solveBudget, solverStats) || solver.solutions() != 1) return false;
+        uint8_t solution[KERNEL_CELLS];
+        memcpy(solution, solver.solution(), KERNEL_CELLS);
+        vector<int> clues;
+        for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+            if (board[cell] != 0) clues.push_back(cell);
+        }
+        results.assign(clues.size(), 0);
+        atomic<int> next(0);
+        pool.run([&](int worker) {
+            uint8_t trial[KERNEL_CELLS];
+            for (int i = next++; i < (int) clues.size(); i = next++) {
+                memcpy(trial, board, KERNEL_CELLS);
+                trial[clues[i]] = 0;
+                BasicIterativeSolver<Rules> other(trial, 1, propagationOptions, rules);
+                other.exclude(clues[i], solution[clues[i]]);
+                results[i] = searchWithinBudget(other, solveBudget, workerStats[worker]) && other.solutions() == 1;
+            }
+        });
+        mergeStats();
+        return find(results.begin(), results.end(), 0) == results.end();
+    }
+
+    template<typename Rules>
+    void removalSolutionCounts(const uint8_t *board, int cap, vector<int> &counts, const Rules &rules) {
+        BasicIterativeSolver<Rules> solver(board, 2, propagationOptions, rules);
+        bool unique = searchWithinBudget(solver, solveBudget, solverStats) && solver.solutions() == 1;
+        uint8_t solution[KERNEL_CELLS];
+        memcpy(solution, solver.solution(), KERNEL_CELLS);
+        counts.assign(KERNEL_CELLS, 0);
+        atomic<int> next(0);
+        pool.run([&](int worker) {
+            uint8_t trial[KERNEL_CELLS];
+            for (int cell = next++; cell < KERNEL_CELLS; cell = next++) {
+                if (board[cell] == 0) continue;
+                memcpy(trial, board, KERNEL_CELLS);
+                trial[cell] = 0;
+                BasicIterativeSolver<Rules> other(trial, unique ? cap - 1 : cap, propagationOptions, rules);
+                if (unique) other.exclude(cell, solution[cell]);
+                if (!searchWithinBudget(other, solveBudget, workerStats[worker])) counts[cell] = -1;
+                else counts[cell] = other.solutions() + (unique ? 1 : 0);
+            }
+        });
+        mergeStats();
+    }
+
+    // results[i] = removing cells[i] (and with prefix also cells[0..i-1]) leaves a unique puzzle
+    void testRemovals(const uint8_t *board, const vector<int> &cells, bool prefix) {
+        results.assign(cells.size(), 0);
+        // With prefix the first cell is tested alone, which phase 1 already did
+        if (prefix) results[0] = 1;
+        atomic<int> next(prefix ? 1 : 0);
+        pool.run([&](int worker) {
+            uint8_t trial[KERNEL_CELLS];
+            for (int i = next++; i < (int) cells.size(); i = next++) {
+                memcpy(trial, board, KERNEL_CELLS);
+                for (int j = prefix ? 0 : i; j <= i; ++j) {
+                    trial[cells[j]] = 0;
+                }
+                results[i] = classifyBoard(trial, solveBudget, propagationOptions, workerStats[worker]) == UNIQUE_SOLUTION;
+            }
+        });
+        mergeStats();
+    }
+
+    // Add the counters of the workers to the ones of the calling thread
+    void mergeStats() {
+        for (SolverStats &stats: workerStats) {
+            solverStats.add(stats);
+            stats = SolverStats();
+        }
+    }
+
+    WorkerPool pool;
+    vector<SolverStats> workerStats;
+    vector<char> results;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "sudoku_solver.h"
+
+using namespace std;
+
+// Scratch board for the GA operators and the solver: the 81 cells in one block plus the row
+// pointers the int ** interface of the solver expects. One board per thread is allocated up front
+// and reused, so the hot paths never allocate.
+
+struct ScratchBoard {
+    int *rows[GRID_SIDE];
+    int cells[GRID_SIDE * GRID_SIDE];
+
+    ScratchBoard() : cells() {
+        for (int i = 0; i < GRID_SIDE; ++i) {
+            rows[i] = cells + i * GRID_SIDE;
+        }
+    }
+
+    ScratchBoard(const ScratchBoard &) = delete;
+
+    ScratchBoard &operator=(const ScratchBoard &) = delete;
+
+    operator int **() {
+        return rows;
+    }
+};
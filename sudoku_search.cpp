@@ -0,0 +1,11 @@
+#include "sudoku_search.h"
+
+using namespace std;
+
+SolveBudget solveBudget;
+
+SolutionCount classifyBoard(const uint8_t *board, const SolveBudget &budget, const PropagationOptions &options,
+                            SolverStats &stats) {
+    if (activeVariant) return classifyBoard(board, budget, options, stats, TableRules(activeVariant));
+    return classifyBoard(board, budget, options, stats, ClassicRules());
+}
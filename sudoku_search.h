@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include "sudoku_variant.h"
+
+// Iterative solution counting with an explicit stack. Every change to the board (a placement or
+// removed candidates) is recorded on a trail with the old value and mask of the cell, and a guess
+// is undone by rolling the trail back to the mark of its frame. The masks only lose digits along
+// a search path, so a cell is changed at most 9 times and the trail and the stack have fixed sizes:
+// a solver never allocates and never recurses. The search can stop after a number of nodes and
+// continue later from where it stopped.
+
+// A BasicCandidateBoard that records its changes
+template<typename Rules>
+struct BasicTrailBoard : BasicCandidateBoard<Rules> {
+    typedef BasicCandidateBoard<Rules> Base;
+    using Base::cells;
+    using Base::candidates;
+    using Base::empty;
+    using Base::rules;
+
+    struct Change {
+        uint8_t cell;
+        uint8_t value;
+        uint16_t candidates;
+    };
+
+    static const int TRAIL_CAPACITY = KERNEL_CELLS * KERNEL_SIDE;
+
+    Change trail[TRAIL_CAPACITY];
+    int trailSize = 0;
+
+    explicit BasicTrailBoard(const uint8_t *board, const Rules &rules) : Base(board, rules) {}
+
+    bool place(int cell, int digit) {
+        record(cell);
+        cells[cell] = (uint8_t) digit;
+        candidates[cell] = 0;
+        empty--;
+        uint16_t bit = (uint16_t) (1u << digit);
+        bool consistent = true;
+        const uint8_t *peers = rules.peers(cell);
+        for (int i = 0; i < rules.peerCount(cell); ++i) {
+            uint8_t peer = peers[i];
+            if (cells[peer] != 0 || !(candidates[peer] & bit)) continue;
+            record(peer);
+            candidates[peer] &= (uint16_t) ~bit;
+            if (candidates[peer] == 0) consistent = false;
+        }
+        return consistent;
+    }
+
+    bool eliminate(int cell, uint16_t mask) {
+        record(cell);
+        candidates[cell] &= (uint16_t) ~mask;
+        return candidates[cell] != 0;
+    }
+
+    // Undo the changes after the trail position mark
+    void undo(int mark) {
+        while (trailSize > mark) {
+            const Change &change = trail[--trailSize];
+            if (change.value == 0 && cells[change.cell] != 0) empty++;
+            cells[change.cell] = change.value;
+            candidates[change.cell] = change.candidates;
+        }
+    }
+
+private:
+    void record(int cell) {
+        trail[trailSize++] = {(uint8_t) cell, cells[cell], candidates[cell]};
+    }
+};
+
+template<typename Rules>
+class BasicIterativeSolver {
+public:
+    // Start counting the solutions of a packed board, up to limit
+    BasicIterativeSolver(const uint8_t *board, int limit, const PropagationOptions &options,
+                         const Rules &rules = Rules())
+            : state(board, rules), options(options), limit(limit), initialEmpty(state.empty) {
+        if (state.empty == 0) {
+            found = 1;
+            memcpy(firstSolution, state.cells, KERNEL_CELLS);
+            done = true;
+        }
+    }
+
+    // Forbid a digit in an empty cell, before the search starts
+    void exclude(int cell, int digit) {
+        if (state.cells[cell] != 0 || !(state.candidates[cell] & (1u << digit))) return;
+        if (!state.eliminate(cell, (uint16_t) (1u << digit))) done = true;
+    }
+
+    // Continue the search for at most nodeBudget nodes (negative = no limit), returns true when the
+    // search is finished. Counters are added to stats as the search goes.
+    bool resume(long long nodeBudget, SolverStats &stats) {
+        long long stop = nodeBudget < 0 ? -1 : expanded + nodeBudget;
+        while (!done) {
+            if (expand) {
+                if (expanded == stop) return false;
+                expanded++;
+                expand = false;
+                if (!propagate(state, options, stats)) {
+                    stats.contradictions++;
+                } else if (state.empty == 0) {
+                    if (found++ == 0) memcpy(firstSolution, state.cells, KERNEL_CELLS);
+                    if (found >= limit) done = true;
+                } else {
+                    push();
+                }
+                continue;
+            }
+            if (depth == 0) {
+                done = true;
+                break;
+            }
+            Frame &frame = stack[depth - 1];
+            state.undo(frame.mark);
+            if (frame.remaining == 0) {
+                depth--;
+                continue;
+            }
+            int digit = __builtin_ctz(frame.remaining);
+            frame.remaining &= (uint16_t) (frame.remaining - 1);
+            stats.guesses++;
+            if (state.place(frame.cell, digit)) expand = true;
+            else stats.contradictions++;
+        }
+        return true;
+    }
+
+    bool finished() const {
+        return done;
+    }
+
+    // Solutions found so far, at most limit
+    int solutions() const {
+        return found;
+    }
+
+    // The first solution, valid when solutions() > 0
+    const uint8_t *solution() const {
+        return firstSolution;
+    }
+
+    long long nodes() const {
+        return expanded;
+    }
+
+    // Empty cells of the board the search started from
+    int emptyCells() const {
+        return initialEmpty;
+    }
+
+private:
+    struct Frame {
+        uint8_t cell;
+        uint16_t remaining; // candidates not tried yet
+        int mark; // trail size before the guesses of this frame
+    };
+
+    // Branch on the empty cell with the fewest candidates
+    void push() {
+        int best = -1, fewest = KERNEL_SIDE + 1;
+        for (int cell = 0; cell < KERNEL_CELLS && fewest > 2; ++cell) {
+            if (state.cells[cell] != 0) continue;
+            int candidates = bitCounts.counts[state.candidates[cell]];
+            if (candidates < fewest) {
+                fewest = candidates;
+                best = cell;
+            }
+        }
+        stack[depth++] = {(uint8_t) best, state.candidates[best], state.trailSize};
+    }
+
+    BasicTrailBoard<Rules> state;
+    PropagationOptions options;
+    Frame stack[KERNEL_CELLS];
+    int depth = 0;
+    int limit;
+    int initialEmpty;
+    int found = 0;
+    long long expanded = 0;
+    bool expand = true; // the current board has not been propagated yet
+    bool done = false;
+    uint8_t firstSolution[KERNEL_CELLS];
+};
+
+typedef BasicIterativeSolver<ClassicRules> IterativeSolver;
+
+// Outcome of a solver call with a budget
+enum SolutionCount {
+    NO_SOLUTION, UNIQUE_SOLUTION, MULTIPLE_SOLUTIONS, UNKNOWN_SOLUTIONS // budget exhausted
+};
+
+// Limits of one solver call, 0 = no limit
+struct SolveBudget {
+    long long maxNodes = 0;
+    double maxSeconds = 0.0;
+};
+
+// Limits of the solver calls of the generator
+extern SolveBudget solveBudget;
+
+// Nodes searched between two looks at the clock
+const long long DEADLINE_CHECK_NODES = 256;
+
+// Run a search to its end or until the budget is used up, false if the budget ran out
+template<typename Solver>
+bool searchWithinBudget(Solver &solver, const SolveBudget &budget, SolverStats &stats) {
+    stats.calls++;
+    stats.emptyCells += solver.emptyCells();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(budget.maxSeconds);
+    bool finished = false;
+    while (!finished) {
+        long long slice = budget.maxSeconds > 0 ? DEADLINE_CHECK_NODES : -1;
+        if (budget.maxNodes > 0) {
+            long long left = budget.maxNodes - solver.nodes();
+            slice = slice < 0 ? left : std::min(slice, left);
+        }
+        finished = solver.resume(slice, stats);
+        if (finished) break;
+        if ((budget.maxNodes > 0 && solver.nodes() >= budget.maxNodes) ||
+            (budget.maxSeconds > 0 && std::chrono::steady_clock::now() >= deadline)) {
+            stats.nodes += solver.nodes();
+            stats.budgetExhaustions++;
+            return false;
+        }
+    }
+    stats.nodes += solver.nodes();
+    return true;
+}
+
+// Count the solutions of a packed board up to two within the budget
+template<typename Rules>
+SolutionCount classifyBoard(const uint8_t *board, const SolveBudget &budget, const PropagationOptions &options,
+                            SolverStats &stats, const Rules &rules) {
+    BasicIterativeSolver<Rules> solver(board, 2, options, rules);
+    if (!searchWithinBudget(solver, budget, stats)) return UNKNOWN_SOLUTIONS;
+    if (solver.solutions() == 0) return NO_SOLUTION;
+    return solver.solutions() == 1 ? UNIQUE_SOLUTION : MULTIPLE_SOLUTIONS;
+}
+
+// The same under the rules of the active variant
+SolutionCount classifyBoard(const uint8_t *board, const SolveBudget &budget, const PropagationOptions &options,
+                            SolverStats &stats);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "sudoku_canonical.cpp"
+#include "sudoku_population.cpp"
+
+using namespace std;
+
+// Known valid grids used to seed the population. Every seeded individual is a random symmetry of
+// one of them, so a run starts with valid grids without repeating the same ones.
+class SeedGrids {
+public:
+    // One grid of 81 digits per line, empty lines and lines starting with # are skipped.
+    // Lines that are not complete valid grids are rejected.
+    bool load(const string &path) {
+        ifstream in(path);
+        if (!in) {
+            cerr << "Cannot open seed grid file " << path << endl;
+            return false;
+        }
+        string line;
+        int lineNumber = 0;
+        while (getline(in, line)) {
+            lineNumber++;
+            while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+            if (line.empty() || line[0] == '#') continue;
+            uint8_t board[GENOME_LENGTH];
+            bool valid = line.size() == GENOME_LENGTH;
+            for (int cell = 0; valid && cell < GENOME_LENGTH; ++cell) {
+                valid = line[cell] >= '1' && line[cell] <= '9';
+                board[cell] = (uint8_t) (line[cell] - '0');
+            }
+            if (!valid || boardRepetitions(board) != 0) {
+                cerr << path << ":" << lineNumber << ": not a valid filled grid" << endl;
+                return false;
+            }
+            grids.insert(grids.end(), board, board + GENOME_LENGTH);
+        }
+        if (grids.empty()) {
+            cerr << "No grids in seed grid file " << path << endl;
+            return false;
+        }
+        return true;
+    }
+
+    int size() const {
+        return (int) (grids.size() / GENOME_LENGTH);
+    }
+
+    // Write a random symmetry of a random grid into board
+    void sample(uint8_t *board, mt19937 &rng) const {
+        uniform_int_distribution<int> pick(0, size() - 1);
+        randomSymmetry(grids.data() + (size_t) pick(rng) * GENOME_LENGTH, board, rng);
+    }
+
+private:
+    vector<uint8_t> grids;
+};
+
+// Fresh individual: a seed grid with probability seedFraction (if there are seed grids),
+// otherwise a constructive random board
+void initializeIndividual(uint8_t *board, const SeedGrids *seeds, float seedFraction, mt19937 &rng) {
+    if (seeds && seeds->size() > 0 && uniform_real_distribution<float>(0.0f, 1.0f)(rng) < seedFraction) {
+        seeds->sample(board, rng);
+    } else {
+        initializeBoard(board, rng);
+    }
+}
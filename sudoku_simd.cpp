@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <cstring>
+#include "sudoku_simd.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SUDOKU_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+UnitCells::UnitCells() : cells() {
+    for (int unit = 0; unit < KERNEL_UNITS; ++unit) {
+        for (int i = 0; i < KERNEL_SIDE; ++i) {
+            cells[unit][i] = unitCell(unit, i);
+        }
+    }
+}
+
+const UnitCells unitCells;
+
+BitCounts::BitCounts() : counts() {
+    for (int mask = 1; mask < (1 << 10); ++mask) {
+        counts[mask] = (uint8_t) (counts[mask >> 1] + (mask & 1));
+    }
+}
+
+const BitCounts bitCounts;
+
+int boardRepetitions(const uint8_t *board) {
+    int unique = 0;
+    for (int unit = 0; unit < KERNEL_SIDE; ++unit) {
+        unsigned rowSeen = 0, rowTwice = 0, colSeen = 0, colTwice = 0, boxSeen = 0, boxTwice = 0;
+        int boxStart = (unit / 3) * 3 * KERNEL_SIDE + (unit % 3) * 3;
+        for (int i = 0; i < KERNEL_SIDE; ++i) {
+            unsigned rowBit = 1u << board[unit * KERNEL_SIDE + i];
+            unsigned colBit = 1u << board[i * KERNEL_SIDE + unit];
+            unsigned boxBit = 1u << board[boxStart + (i / 3) * KERNEL_SIDE + i % 3];
+            rowTwice |= rowSeen & rowBit;
+            rowSeen |= rowBit;
+            colTwice |= colSeen & colBit;
+            colSeen |= colBit;
+            boxTwice |= boxSeen & boxBit;
+            boxSeen |= boxBit;
+        }
+        unique += bitCounts.counts[rowSeen & ~rowTwice] + bitCounts.counts[colSeen & ~colTwice] +
+                  bitCounts.counts[boxSeen & ~boxTwice];
+    }
+    return KERNEL_UNITS * KERNEL_SIDE - unique;
+}
+
+void repetitionsScalar(const uint8_t *boards, int count, int *repetitions) {
+    for (int i = 0; i < count; ++i) {
+        repetitions[i] = boardRepetitions(boards + (size_t) i * KERNEL_CELLS);
+    }
+}
+
+#ifdef SUDOKU_X86_KERNELS
+
+// Copy `lanes` boards into a cell-major tile of `width` byte lanes, unused lanes are empty boards
+inline void transposeBoards(const uint8_t *boards, int lanes, int width, uint8_t *tile) {
+    if (lanes < width) memset(tile, 0, (size_t) KERNEL_CELLS * width);
+    for (int lane = 0; lane < lanes; ++lane) {
+        const uint8_t *board = boards + (size_t) lane * KERNEL_CELLS;
+        for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+            tile[cell * width + lane] = board[cell];
+        }
+    }
+}
+
+__attribute__((target("ssse3")))
+void repetitionsSSSE3(const uint8_t *boards, int count, int *repetitions) {
+    // One-hot of digits 0-7 and of digits 8-9, and the popcount of a nibble
+    const __m128i lowBits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char) 128, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i highBits = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 0, 0, 0, 0, 0, 0);
+    const __m128i nibbleCounts = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+    alignas(16) uint8_t tile[KERNEL_CELLS * 16];
+    alignas(16) uint8_t unique[16];
+    for (int first = 0; first < count; first += 16) {
+        int lanes = min(16, count - first);
+        transposeBoards(boards + (size_t) first * KERNEL_CELLS, lanes, 16, tile);
+        __m128i total = _mm_setzero_si128();
+        for (int unit = 0; unit < KERNEL_UNITS; ++unit) {
+            __m128i lowSeen = _mm_setzero_si128(), lowTwice = _mm_setzero_si128();
+            __m128i highSeen = _mm_setzero_si128(), highTwice = _mm_setzero_si128();
+            for (int i = 0; i < KERNEL_SIDE; ++i) {
+                __m128i digits = _mm_load_si128((const __m128i *) (tile + unitCells.cells[unit][i] * 16));
+                __m128i low = _mm_shuffle_epi8(lowBits, digits);
+                __m128i high = _mm_shuffle_epi8(highBits, digits);
+                lowTwice = _mm_or_si128(lowTwice, _mm_and_si128(lowSeen, low));
+                lowSeen = _mm_or_si128(lowSeen, low);
+                highTwice = _mm_or_si128(highTwice, _mm_and_si128(highSeen, high));
+                highSeen = _mm_or_si128(highSeen, high);
+            }
+            __m128i once = _mm_andnot_si128(lowTwice, lowSeen);
+            __m128i onceHigh = _mm_andnot_si128(highTwice, highSeen);
+            total = _mm_add_epi8(total, _mm_shuffle_epi8(nibbleCounts, _mm_and_si128(once, nibbleMask)));
+            total = _mm_add_epi8(total, _mm_shuffle_epi8(nibbleCounts, _mm_and_si128(_mm_srli_epi16(once, 4), nibbleMask)));
+            total = _mm_add_epi8(total, _mm_shuffle_epi8(nibbleCounts, onceHigh));
+        }
+        _mm_store_si128((__m128i *) unique, total);
+        for (int lane = 0; lane < lanes; ++lane) {
+            repetitions[first + lane] = KERNEL_UNITS * KERNEL_SIDE - unique[lane];
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+void repetitionsAVX2(const uint8_t *boards, int count, int *repetitions) {
+    // _mm256_shuffle_epi8 works per 128-bit half, so the tables are repeated in both halves
+    const __m256i lowBits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char) 128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                             1, 2, 4, 8, 16, 32, 64, (char) 128, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i highBits = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 0, 0, 0, 0, 0, 0,
+                                              0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 0, 0, 0, 0, 0, 0);
+    const __m256i nibbleCounts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                  0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+    alignas(32) uint8_t tile[KERNEL_CELLS * 32];
+    alignas(32) uint8_t unique[32];
+    for (int first = 0; first < count; first += 32) {
+        int lanes = min(32, count - first);
+        transposeBoards(boards + (size_t) first * KERNEL_CELLS, lanes, 32, tile);
+        __m256i total = _mm256_setzero_si256();
+        for (int unit = 0; unit < KERNEL_UNITS; ++unit) {
+            __m256i lowSeen = _mm256_setzero_si256(), lowTwice = _mm256_setzero_si256();
+            __m256i highSeen = _mm256_setzero_si256(), highTwice = _mm256_setzero_si256();
+            for (int i = 0; i < KERNEL_SIDE; ++i) {
+                __m256i digits = _mm256_load_si256((const __m256i *) (tile + unitCells.cells[unit][i] * 32));
+                __m256i low = _mm256_shuffle_epi8(lowBits, digits);
+                __m256i high = _mm256_shuffle_epi8(highBits, digits);
+                lowTwice = _mm256_or_si256(lowTwice, _mm256_and_si256(lowSeen, low));
+                lowSeen = _mm256_or_si256(lowSeen, low);
+                highTwice = _mm256_or_si256(highTwice, _mm256_and_si256(highSeen, high));
+                highSeen = _mm256_or_si256(highSeen, high);
+            }
+            __m256i once = _mm256_andnot_si256(lowTwice, lowSeen);
+            __m256i onceHigh = _mm256_andnot_si256(highTwice, highSeen);
+            total = _mm256_add_epi8(total, _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(once, nibbleMask)));
+            total = _mm256_add_epi8(total, _mm256_shuffle_epi8(nibbleCounts,
+                                                               _mm256_and_si256(_mm256_srli_epi16(once, 4), nibbleMask)));
+            total = _mm256_add_epi8(total, _mm256_shuffle_epi8(nibbleCounts, onceHigh));
+        }
+        _mm256_store_si256((__m256i *) unique, total);
+        for (int lane = 0; lane < lanes; ++lane) {
+            repetitions[first + lane] = KERNEL_UNITS * KERNEL_SIDE - unique[lane];
+        }
+    }
+}
+
+#endif
+
+KernelChoice detectKernel() {
+#ifdef SUDOKU_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {"avx2", repetitionsAVX2};
+    if (__builtin_cpu_supports("ssse3")) return {"ssse3", repetitionsSSSE3};
+#endif
+    return {"scalar", repetitionsScalar};
+}
+
+KernelChoice &activeKernel() {
+    static KernelChoice choice = detectKernel();
+    return choice;
+}
+
+const char *repetitionsKernelName() {
+    return activeKernel().name;
+}
+
+bool selectRepetitionsKernel(const string &name) {
+    if (name == "scalar") {
+        activeKernel() = {"scalar", repetitionsScalar};
+        return true;
+    }
+#ifdef SUDOKU_X86_KERNELS
+    __builtin_cpu_init();
+    if (name == "ssse3" && __builtin_cpu_supports("ssse3")) {
+        activeKernel() = {"ssse3", repetitionsSSSE3};
+        return true;
+    }
+    if (name == "avx2" && __builtin_cpu_supports("avx2")) {
+        activeKernel() = {"avx2", repetitionsAVX2};
+        return true;
+    }
+#endif
+    return false;
+}
+
+void boardRepetitionsBatch(const uint8_t *boards, int count, int *repetitions) {
+    activeKernel().kernel(boards, count, repetitions);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Conflict counting kernels for packed 9x9 boards (81 bytes, one digit per byte, 0 = empty).
+// The repetitions of a board are the number of cells whose digit occurs more than once in their
+// row, column and box, a cell counting once per unit. Per unit this is 9 minus the number of
+// digits that occur exactly once, which is computed from "seen" and "seen twice" bitmasks.
+//
+// The scalar kernel scores one board. The SSSE3 and AVX2 kernels score 16 or 32 boards per pass:
+// the boards are transposed into a cell-major tile so that one byte lane holds one board, the
+// digits are turned into one-hot bytes with a table shuffle and the unique digits are counted
+// with a nibble popcount. The best kernel is picked at run time.
+
+const int KERNEL_SIDE = 9;
+const int KERNEL_CELLS = KERNEL_SIDE * KERNEL_SIDE;
+const int KERNEL_UNITS = 3 * KERNEL_SIDE;
+
+// Cell i of a unit: rows, then columns, then boxes
+inline uint8_t unitCell(int unit, int i) {
+    if (unit < KERNEL_SIDE) return (uint8_t) (unit * KERNEL_SIDE + i);
+    if (unit < 2 * KERNEL_SIDE) return (uint8_t) (i * KERNEL_SIDE + unit - KERNEL_SIDE);
+    int box = unit - 2 * KERNEL_SIDE;
+    return (uint8_t) (((box / 3) * 3 + i / 3) * KERNEL_SIDE + (box % 3) * 3 + i % 3);
+}
+
+// Cells of the 27 units
+struct UnitCells {
+    uint8_t cells[KERNEL_UNITS][KERNEL_SIDE];
+
+    UnitCells();
+};
+
+extern const UnitCells unitCells;
+
+// Number of set bits of the 10-bit digit masks
+struct BitCounts {
+    uint8_t counts[1 << 10];
+
+    BitCounts();
+};
+
+extern const BitCounts bitCounts;
+
+int boardRepetitions(const uint8_t *board);
+
+typedef void (*RepetitionsKernel)(const uint8_t *boards, int count, int *repetitions);
+
+struct KernelChoice {
+    const char *name;
+    RepetitionsKernel kernel;
+};
+
+// The fastest kernel of this CPU
+KernelChoice detectKernel();
+
+const char *repetitionsKernelName();
+
+// Force a kernel ("scalar", "ssse3" or "avx2"), returns false if the CPU does not support it
+bool selectRepetitionsKernel(const std::string &name);
+
+// Repetitions of `count` boards stored back to back, with the selected kernel
+void boardRepetitionsBatch(const uint8_t *boards, int count, int *repetitions);
@@ -0,0 +1,69 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "sudoku_core.h"
+
+using namespace std;
+
+// Solves puzzles with the sudoku_core library, one puzzle of 81 characters per line on stdin,
+// '0' or '.' for empty cells. Prints the status and the solution of every puzzle and exits with 1
+// if any puzzle had no unique solution.
+// Usage: sudoku_solve [--grid] [--locked-candidates] [--node-budget NODES] [--time-budget SECONDS]
+
+const char *statusName(sudoku::Solutions solutions) {
+    switch (solutions) {
+        case sudoku::Solutions::NONE:
+            return "none";
+        case sudoku::Solutions::UNIQUE:
+            return "unique";
+        case sudoku::Solutions::MULTIPLE:
+            return "multiple";
+        default:
+            return "unknown";
+    }
+}
+
+int main(int argc, char **argv) {
+    bool grid = false;
+    sudoku::SolveLimits limits;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--grid") {
+            grid = true;
+        } else if (arg == "--locked-candidates") {
+            limits.lockedCandidates = true;
+        } else if (arg == "--node-budget" && i + 1 < argc) {
+            limits.maxNodes = atoll(argv[++i]);
+        } else if (arg == "--time-budget" && i + 1 < argc) {
+            limits.maxSeconds = atof(argv[++i]);
+        } else {
+            cerr << "Usage: " << argv[0]
+                 << " [--grid] [--locked-candidates] [--node-budget NODES] [--time-budget SECONDS]" << endl;
+            return 1;
+        }
+    }
+
+    bool allUnique = true;
+    string line;
+    while (getline(cin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        sudoku::Board board;
+        if (!sudoku::parseBoard(line, board)) {
+            cout << "invalid " << line << endl;
+            allUnique = false;
+            continue;
+        }
+        sudoku::Solutions solutions = sudoku::countSolutions(board, limits);
+        sudoku::Board solution;
+        bool solved = solutions != sudoku::Solutions::NONE && solutions != sudoku::Solutions::UNKNOWN &&
+                      sudoku::solve(board, solution, limits);
+        if (!grid) {
+            cout << statusName(solutions) << " " << (solved ? sudoku::formatLine(solution) : line) << endl;
+        } else {
+            cout << statusName(solutions) << endl << sudoku::formatGrid(solved ? solution : board) << endl;
+        }
+        allUnique = allUnique && solutions == sudoku::Solutions::UNIQUE;
+    }
+    return allUnique ? 0 : 1;
+}
@@ -1,18 +1,17 @@
 #include <iostream>
-
-const int N = 9;
+#include "sudoku_solver.h"
 
 using namespace std;
 
 bool isPresentInCol(int col, int num, int **grid) { //check whether num is present in col or not
-    for (int row = 0; row < N; row++)
+    for (int row = 0; row < GRID_SIDE; row++)
         if (grid[row][col] == num)
             return true;
     return false;
 }
 
 bool isPresentInRow(int row, int num, int **grid) { //check whether num is present in row or not
-    for (int col = 0; col < N; col++)
+    for (int col = 0; col < GRID_SIDE; col++)
         if (grid[row][col] == num)
             return true;
     return false;
@@ -30,7 +29,7 @@ int isNumberRepeated(int row, int col, int num, int **sudoku) {
     int count = 0;
     int repetitions = 0;
     // Check row
-    for (int i = 0; i < N; ++i) {
+    for (int i = 0; i < GRID_SIDE; ++i) {
         if (sudoku[row][i] == num) {
             count++;
             if (count > 1) {
@@ -41,7 +40,7 @@ int isNumberRepeated(int row, int col, int num, int **sudoku) {
     }
     // Check column
     count = 0;
-    for (int i = 0; i < N; ++i) {
+    for (int i = 0; i < GRID_SIDE; ++i) {
         if (sudoku[i][col] == num) {
             count++;
             if (count > 1) {
@@ -72,15 +71,15 @@ int isNumberRepeated(int row, int col, int num, int **sudoku) {
 }
 
 void sudokuGrid(int **grid) { //print the sudoku grid after solve
-    for (int row = 0; row < N; row++) {
-        for (int col = 0; col < N; col++) {
+    for (int row = 0; row < GRID_SIDE; row++) {
+        for (int col = 0; col < GRID_SIDE; col++) {
             if (col == 3 || col == 6)
                 cout << " | ";
             cout << grid[row][col] << " ";
         }
         if (row == 2 || row == 5) {
             cout << endl;
-            for (int i = 0; i < N; i++)
+            for (int i = 0; i < GRID_SIDE; i++)
                 cout << "---";
         }
         cout << endl;
@@ -88,13 +87,18 @@ void sudokuGrid(int **grid) { //print the sudoku grid after solve
 }
 
 bool findEmptyPlace(int &row, int &col, int **grid) { //get empty location and update row and column
-    for (row = 0; row < N; row++)
-        for (col = 0; col < N; col++)
+    for (row = 0; row < GRID_SIDE; row++)
+        for (col = 0; col < GRID_SIDE; col++)
             if (grid[row][col] == 0) //marked with 0 is empty
                 return true;
     return false;
 }
 
+bool isValidInVariant(int row, int col, int num, int **grid) {
+    return activeVariant->allows(row * GRID_SIDE + col, num,
+                                 [grid](int cell) { return grid[cell / GRID_SIDE][cell % GRID_SIDE]; });
+}
+
 bool isValidPlace(int row, int col, int num, int **grid) {
     //when item not found in col, row and current 3x3 box
     return !isPresentInRow(row, num, grid) && !isPresentInCol(col, num, grid) && !isPresentInBox(row - row % 3,
@@ -104,14 +108,16 @@ bool isValidPlace(int row, int col, int num, int **grid) {
 
 int countZeros(int **grid) {
     int count = 0;
-    for (int i = 0; i < N; ++i) {
-        for (int j = 0; j < N; ++j) {
+    for (int i = 0; i < GRID_SIDE; ++i) {
+        for (int j = 0; j < GRID_SIDE; ++j) {
             if (grid[i][j] == 0) count++;
         }
     }
     return count;
 }
 
+// Variant adds the checks of the active variant, the classic instance is the plain recursion
+template<bool Variant>
 bool solveSudokuRecursion(int **grid, int &solutionCount) {
     int row, col;
     if (!findEmptyPlace(row, col, grid)) {
@@ -119,9 +125,10 @@ bool solveSudokuRecursion(int **grid, int &solutionCount) {
         return solutionCount == 1; // Return true if there is only one solution
     }
     for (int num = 1; num <= 9; num++) { //valid numbers are 1 - 9
-        if (isValidPlace(row, col, num, grid)) { //check validation, if yes, put the number in the grid
+        if (isValidPlace(row, col, num, grid) && (!Variant || isValidInVariant(row, col, num, grid))) {
+            //check validation, if yes, put the number in the grid
             grid[row][col] = num;
-            if (!solveSudokuRecursion(grid, solutionCount)) // Return false if more than one solution found
+            if (!solveSudokuRecursion<Variant>(grid, solutionCount)) // Return false if more than one solution found
                 return false;
             grid[row][col] = 0; //turn to unassigned space
         }
@@ -129,26 +136,56 @@ bool solveSudokuRecursion(int **grid, int &solutionCount) {
     return true;
 }
 
+void packGrid(int **grid, uint8_t *board) {
+    for (int row = 0; row < GRID_SIDE; row++) {
+        for (int col = 0; col < GRID_SIDE; col++) {
+            board[row * GRID_SIDE + col] = (uint8_t) grid[row][col];
+        }
+    }
+}
+
+SolutionCount classifySudoku(int **grid) {
+    if (!propagationOptions.enabled) {
+        int solutionCount = 0;
+        if (activeVariant) solveSudokuRecursion<true>(grid, solutionCount);
+        else solveSudokuRecursion<false>(grid, solutionCount);
+        if (solutionCount == 0) return NO_SOLUTION;
+        return solutionCount == 1 ? UNIQUE_SOLUTION : MULTIPLE_SOLUTIONS;
+    }
+    uint8_t board[GRID_SIDE * GRID_SIDE];
+    packGrid(grid, board);
+    return classifyBoard(board, solveBudget, propagationOptions, solverStats);
+}
+
 bool solveSudoku(int **grid) {
-    int solutionCount = 0;
-    return solveSudokuRecursion(grid, solutionCount) && solutionCount == 1;
+    return classifySudoku(grid) == UNIQUE_SOLUTION;
 }
 
 
 bool checkSudoku(int **grid) {
-    int repetitions = 0;
-    for (int row = 0; row < N; row++) {
-        for (int col = 0; col < N; col++) {
-            int num = grid[row][col];
-            if (num == 0) return false;
-            repetitions += isNumberRepeated(row, col, num, grid);
+    uint8_t board[GRID_SIDE * GRID_SIDE];
+    for (int row = 0; row < GRID_SIDE; row++) {
+        for (int col = 0; col < GRID_SIDE; col++) {
+            if (grid[row][col] == 0) return false;
+            board[row * GRID_SIDE + col] = (uint8_t) grid[row][col];
         }
     }
-    return repetitions == 0;
+    if (activeVariant) {
+        for (const Cage &cage: activeVariant->cages()) {
+            int sum = 0;
+            for (int i = 0; i < cage.size; ++i) sum += board[cage.cells[i]];
+            if (sum != cage.sum) return false;
+        }
+    }
+    return boardRepetitions(board) + variantRepetitions(board) == 0;
 }
 
 bool isSolvable(int **grid) {
-    if (!solveSudoku(grid)) {
+    SolutionCount solutions = classifySudoku(grid);
+    if (solutions == UNKNOWN_SOLUTIONS) {
+        cout << "Solver budget exceeded" << endl;
+        return false;
+    } else if (solutions != UNIQUE_SOLUTION) {
         cout << "No solution exists" << endl;
         return false;
     } else if (countZeros(grid) == 0 && !checkSudoku(grid)) {
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include "sudoku_search.h"
+
+const int GRID_SIDE = 9;
+
+// The solver on the int grids of the GA: checks for the plain recursion, uniqueness through the
+// propagation solver, the validity check of a filled grid and the printed grid layout.
+
+bool isPresentInCol(int col, int num, int **grid);
+
+bool isPresentInRow(int row, int num, int **grid);
+
+bool isPresentInBox(int boxStartRow, int boxStartCol, int num, int **grid);
+
+int isNumberRepeated(int row, int col, int num, int **sudoku);
+
+void sudokuGrid(int **grid);
+
+bool findEmptyPlace(int &row, int &col, int **grid);
+
+// The extra units and cages of the active variant, which must be set
+bool isValidInVariant(int row, int col, int num, int **grid);
+
+bool isValidPlace(int row, int col, int num, int **grid);
+
+int countZeros(int **grid);
+
+void packGrid(int **grid, uint8_t *board);
+
+// Number of solutions of the grid within solveBudget, left unchanged by the propagation solver.
+// The plain recursion (propagation disabled) has no budget and leaves the second solution in the
+// grid when there are several.
+SolutionCount classifySudoku(int **grid);
+
+// True if the grid is known to have exactly one solution, false when the budget ran out
+bool solveSudoku(int **grid);
+
+// A filled grid without repetitions, and with the cage sums of the active variant
+bool checkSudoku(int **grid);
+
+// Print whether the grid has a unique solution, and for a filled grid whether it is valid
+bool isSolvable(int **grid);
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Per-generation statistics of a GA run
+struct GenerationStats {
+    int run;
+    int generation;
+    double wallSeconds;
+    double evaluationsPerSecond;
+    float bestFitness;
+    float meanFitness;
+    float stddevFitness;
+    float diversity;
+    int populationSize;
+    float mutationProbability;
+    double cacheHitRate;
+};
+
+// Buffered telemetry sink, writes one record every `interval` generations as CSV or JSON lines
+// (chosen by the file extension, .jsonl for JSON lines, anything else for CSV)
+class Telemetry {
+public:
+    Telemetry() : buffer(1 << 16) {}
+
+    ~Telemetry() {
+        close();
+    }
+
+    // With resumeAt >= 0 the file is cut back to the resumeAt bytes it had when the checkpoint of the
+    // resumed run was written, so that the generations after the checkpoint are not recorded twice
+    bool open(const string &path, int samplingInterval, long long resumeAt = -1) {
+        interval = samplingInterval > 0 ? samplingInterval : 1;
+        jsonLines = path.size() >= 6 && path.compare(path.size() - 6, 6, ".jsonl") == 0;
+        if (resumeAt >= 0) {
+            struct stat status;
+            if (stat(path.c_str(), &status) != 0 || status.st_size < resumeAt ||
+                truncate(path.c_str(), (off_t) resumeAt) != 0) {
+                cerr << "Cannot resume telemetry file " << path << endl;
+                return false;
+            }
+        }
+        out.rdbuf()->pubsetbuf(buffer.data(), (streamsize) buffer.size());
+        out.open(path, resumeAt >= 0 ? ios::in | ios::out : ios::out);
+        if (!out) {
+            cerr << "Cannot open telemetry file " << path << endl;
+            return false;
+        }
+        out.seekp(0, ios::end);
+        if (!jsonLines && resumeAt < 0) {
+            out << "run,generation,wall_s,evals_per_s,best,mean,stddev,diversity,population_size,mutation_probability,cache_hit_rate\n";
+        }
+        return true;
+    }
+
+    bool enabled() const {
+        return out.is_open();
+    }
+
+    // Whether the given generation is sampled, so that callers skip collecting statistics otherwise
+    bool samples(int generation) const {
+        return enabled() && generation % interval == 0;
+    }
+
+    void record(const GenerationStats &s) {
+        if (jsonLines) {
+            out << "{\"run\":" << s.run << ",\"generation\":" << s.generation << ",\"wall_s\":" << s.wallSeconds
+                << ",\"evals_per_s\":" << s.evaluationsPerSecond << ",\"best\":" << s.bestFitness
+                << ",\"mean\":" << s.meanFitness << ",\"stddev\":" << s.stddevFitness
+                << ",\"diversity\":" << s.diversity << ",\"population_size\":" << s.populationSize
+                << ",\"mutation_probability\":" << s.mutationProbability
+                << ",\"cache_hit_rate\":" << s.cacheHitRate << "}\n";
+        } else {
+            out << s.run << ',' << s.generation << ',' << s.wallSeconds << ',' << s.evaluationsPerSecond << ','
+                << s.bestFitness << ',' << s.meanFitness << ',' << s.stddevFitness << ',' << s.diversity << ','
+                << s.populationSize << ',' << s.mutationProbability << ',' << s.cacheHitRate << '\n';
+        }
+    }
+
+    // Bytes written so far, flushed so that a checkpoint never refers to bytes the file does not have;
+    // -1 without a file, a resume then starts a new one
+    long long flushedSize() {
+        if (!enabled()) return -1;
+        out.flush();
+        return (long long) out.tellp();
+    }
+
+    void close() {
+        if (out.is_open()) out.close();
+    }
+
+private:
+    vector<char> buffer;
+    ofstream out;
+    bool jsonLines = false;
+    int interval = 1;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Fixed set of worker threads that run one task on every worker and wait for all of them.
+// The calling thread takes part as worker 0, so a pool of size 1 runs everything inline.
+class WorkerPool {
+public:
+    // threads = 0 uses one worker per hardware thread
+    explicit WorkerPool(int threads = 0) {
+        if (threads <= 0) threads = (int) thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+        for (int worker = 1; worker < threads; ++worker) {
+            workers.emplace_back([this, worker] { loop(worker); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (thread &t: workers) {
+            t.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    int size() const {
+        return (int) workers.size() + 1;
+    }
+
+    // Run task(worker) for every worker index and return when all calls are done
+    void run(const function<void(int)> &work) {
+        if (workers.empty()) {
+            work(0);
+            return;
+        }
+        {
+            lock_guard<mutex> lock(mtx);
+            task = &work;
+            pending = (int) workers.size();
+            round++;
+        }
+        wake.notify_all();
+        work(0);
+        unique_lock<mutex> lock(mtx);
+        done.wait(lock, [this] { return pending == 0; });
+        task = nullptr;
+    }
+
+private:
+    void loop(int worker) {
+        long long seen = 0;
+        while (true) {
+            const function<void(int)> *work;
+            {
+                unique_lock<mutex> lock(mtx);
+                wake.wait(lock, [&] { return stopping || round != seen; });
+                if (stopping) return;
+                seen = round;
+                work = task;
+            }
+            (*work)(worker);
+            {
+                lock_guard<mutex> lock(mtx);
+                pending--;
+            }
+            done.notify_one();
+        }
+    }
+
+    vector<thread> workers;
+    mutex mtx;
+    condition_variable wake, done;
+    const function<void(int)> *task = nullptr;
+    int pending = 0;
+    long long round = 0;
+    bool stopping = false;
+};
+
+// The part [begin, end) of [0, count) handled by one of `workers` workers
+void workerRange(int worker, int workers, int count, int &begin, int &end) {
+    begin = (int) ((long long) count * worker / workers);
+    end = (int) ((long long) count * (worker + 1) / workers);
+}
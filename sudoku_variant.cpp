@@ -0,0 +1,129 @@
+#include "sudoku_variant.h"
+
+using namespace std;
+
+bool isVariant(const string &name) {
+    return name == "classic" || name == "x" || name == "windoku" || name == "killer";
+}
+
+string cellName(int cell) {
+    return "r" + to_string(cell / KERNEL_SIDE + 1) + "c" + to_string(cell % KERNEL_SIDE + 1);
+}
+
+ConstraintTable::ConstraintTable(const string &variant) : variantName(variant) {
+    fill(cageIndex, cageIndex + KERNEL_CELLS, -1);
+    array<uint8_t, KERNEL_SIDE> unit;
+    for (int u = 0; u < KERNEL_UNITS; ++u) {
+        for (int i = 0; i < KERNEL_SIDE; ++i) unit[i] = unitCell(u, i);
+        units.push_back(unit);
+    }
+    if (variant == "x") {
+        for (int i = 0; i < KERNEL_SIDE; ++i) unit[i] = (uint8_t) (i * (KERNEL_SIDE + 1));
+        units.push_back(unit);
+        for (int i = 0; i < KERNEL_SIDE; ++i) unit[i] = (uint8_t) ((i + 1) * (KERNEL_SIDE - 1));
+        units.push_back(unit);
+    } else if (variant == "windoku") {
+        for (int top: {1, 5}) {
+            for (int left: {1, 5}) {
+                for (int i = 0; i < KERNEL_SIDE; ++i) unit[i] = (uint8_t) ((top + i / 3) * KERNEL_SIDE + left + i % 3);
+                units.push_back(unit);
+            }
+        }
+    }
+    buildPeers();
+}
+
+void ConstraintTable::setRandomCages(const uint8_t *solution, mt19937 &rng) {
+    cageList.clear();
+    fill(cageIndex, cageIndex + KERNEL_CELLS, -1);
+    vector<int> order(KERNEL_CELLS);
+    for (int cell = 0; cell < KERNEL_CELLS; ++cell) order[cell] = cell;
+    shuffle(order.begin(), order.end(), rng);
+    for (int start: order) {
+        if (cageIndex[start] >= 0) continue;
+        Cage cage{};
+        int target = uniform_int_distribution<int>(2, MAX_CAGE_SIZE)(rng);
+        uint16_t digits = 0;
+        addToCage(cage, start, solution, digits);
+        for (int tries = 0; cage.size < target && tries < 4 * MAX_CAGE_SIZE; ++tries) {
+            // A random neighbour of a random cell of the cage
+            int from = cage.cells[uniform_int_distribution<int>(0, cage.size - 1)(rng)];
+            int direction = uniform_int_distribution<int>(0, 3)(rng);
+            int row = from / KERNEL_SIDE + (direction == 0) - (direction == 1);
+            int col = from % KERNEL_SIDE + (direction == 2) - (direction == 3);
+            if (row < 0 || row >= KERNEL_SIDE || col < 0 || col >= KERNEL_SIDE) continue;
+            int next = row * KERNEL_SIDE + col;
+            if (cageIndex[next] >= 0 || (digits & (1u << solution[next]))) continue;
+            addToCage(cage, next, solution, digits);
+        }
+        cageList.push_back(cage);
+    }
+    buildPeers();
+}
+
+int ConstraintTable::extraRepetitions(const uint8_t *board) const {
+    int repetitions = 0;
+    for (int u = KERNEL_UNITS; u < (int) units.size(); ++u) {
+        unsigned seen = 0, twice = 0;
+        for (uint8_t cell: units[u]) {
+            unsigned bit = 1u << board[cell];
+            twice |= seen & bit;
+            seen |= bit;
+        }
+        repetitions += KERNEL_SIDE - bitCounts.counts[seen & ~twice];
+    }
+    return repetitions;
+}
+
+string ConstraintTable::describeCages() const {
+    string text;
+    for (const Cage &cage: cageList) {
+        if (!text.empty()) text += ' ';
+        text += to_string(cage.sum) + ":";
+        for (int i = 0; i < cage.size; ++i) {
+            text += (i > 0 ? "+" : "") + cellName(cage.cells[i]);
+        }
+    }
+    return text;
+}
+
+void ConstraintTable::addToCage(Cage &cage, int cell, const uint8_t *solution, uint16_t &digits) {
+    cage.cells[cage.size++] = (uint8_t) cell;
+    cage.sum += solution[cell];
+    digits |= (uint16_t) (1u << solution[cell]);
+    cageIndex[cell] = (int) cageList.size();
+}
+
+void ConstraintTable::buildPeers() {
+    bool peer[KERNEL_CELLS][KERNEL_CELLS] = {};
+    auto link = [&peer](const uint8_t *cells, int size) {
+        for (int i = 0; i < size; ++i) {
+            for (int j = 0; j < size; ++j) {
+                if (i != j) peer[cells[i]][cells[j]] = true;
+            }
+        }
+    };
+    for (const array<uint8_t, KERNEL_SIDE> &unit: units) link(unit.data(), KERNEL_SIDE);
+    for (const Cage &cage: cageList) link(cage.cells, cage.size);
+    for (int cell = 0; cell < KERNEL_CELLS; ++cell) {
+        peerCounts[cell] = 0;
+        for (int other = 0; other < KERNEL_CELLS; ++other) {
+            if (peer[cell][other]) peerLists[cell][peerCounts[cell]++] = (uint8_t) other;
+        }
+    }
+}
+
+ConstraintTable *activeVariant = nullptr;
+
+CageCombinations::CageCombinations() {
+    for (unsigned digits = 0; digits < (1u << KERNEL_SIDE); ++digits) {
+        int sum = 0;
+        for (int digit = 1; digit <= KERNEL_SIDE; ++digit) {
+            if (digits & (1u << (digit - 1))) sum += digit;
+        }
+        masks[__builtin_popcount(digits)][sum].push_back((uint16_t) (digits << 1));
+    }
+}
+
+// Built with __builtin_popcount, bitCounts may be initialized after it
+const CageCombinations cageCombinations;
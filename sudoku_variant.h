@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "sudoku_propagation.h"
+
+// Sudoku variants as a table of constraints on top of the classic grid. A variant adds units, sets
+// of nine cells that hold every digit once (the diagonals of X-Sudoku, the four extra windows of
+// Windoku), and cages, sets of cells with different digits that add up to a sum (Killer). The
+// peers of a cell are the cells sharing a unit or a cage with it.
+//
+// The solver, the fitness and the removal read the table through TableRules. The classic grid
+// does not go through the table: it keeps the fixed tables of ClassicRules, and activeVariant is
+// nullptr, so the solver and the fitness kernels are the same as without variants.
+
+const char *const VARIANTS = "classic, x, windoku or killer";
+
+bool isVariant(const std::string &name);
+
+// Largest cage of the generated Killer puzzles
+const int MAX_CAGE_SIZE = 4;
+
+struct Cage {
+    uint8_t cells[KERNEL_SIDE];
+    int size;
+    int sum;
+};
+
+std::string cellName(int cell);
+
+class ConstraintTable {
+public:
+    explicit ConstraintTable(const std::string &variant = "classic");
+
+    const std::string &name() const {
+        return variantName;
+    }
+
+    // Units beyond the rows, columns and boxes
+    bool hasExtraUnits() const {
+        return (int) units.size() > KERNEL_UNITS;
+    }
+
+    int unitCount() const {
+        return (int) units.size();
+    }
+
+    const uint8_t *unit(int index) const {
+        return units[index].data();
+    }
+
+    int peerCount(int cell) const {
+        return peerCounts[cell];
+    }
+
+    const uint8_t *peers(int cell) const {
+        return peerLists[cell];
+    }
+
+    // Killer: cages are drawn with setRandomCages for every solution grid
+    bool hasCages() const {
+        return variantName == "killer";
+    }
+
+    const std::vector<Cage> &cages() const {
+        return cageList;
+    }
+
+    // Index of the cage of a cell, -1 if it is in none
+    int cageOf(int cell) const {
+        return cageIndex[cell];
+    }
+
+    // Replace the cages by a random partition of the grid into connected cages of up to
+    // MAX_CAGE_SIZE cells with different digits, summed from the solution
+    void setRandomCages(const uint8_t *solution, std::mt19937 &rng);
+
+    // Whether digit can go into cell next to the digits of board (cell by cell through at): no
+    // repetition in an extra unit or a cage, and no cage over its sum
+    template<typename Cells>
+    bool allows(int cell, int digit, const Cells &at) const {
+        for (int u = KERNEL_UNITS; u < (int) units.size(); ++u) {
+            const std::array<uint8_t, KERNEL_SIDE> &unit = units[u];
+            if (std::find(unit.begin(), unit.end(), cell) == unit.end()) continue;
+            for (uint8_t other: unit) {
+                if (other != cell && at(other) == digit) return false;
+            }
+        }
+        if (cageIndex[cell] < 0) return true;
+        const Cage &cage = cageList[cageIndex[cell]];
+        int sum = digit, empty = 0;
+        for (int i = 0; i < cage.size; ++i) {
+            int other = cage.cells[i];
+            if (other == cell) continue;
+            if (at(other) == digit) return false;
+            sum += at(other);
+            if (at(other) == 0) empty++;
+        }
+        return empty > 0 ? sum < cage.sum : sum == cage.sum;
+    }
+
+    // Repetitions of a filled board in the extra units, counted like boardRepetitions
+    int extraRepetitions(const uint8_t *board) const;
+
+    // The cages as text, "<sum>:<cell>+<cell>..." separated by spaces
+    std::string describeCages() const;
+
+private:
+    void addToCage(Cage &cage, int cell, const uint8_t *solution, uint16_t &digits);
+
+    void buildPeers();
+
+    std::string variantName;
+    std::vector<std::array<uint8_t, KERNEL_SIDE>> units; // rows, columns and boxes first
+    std::vector<Cage> cageList;
+    int cageIndex[KERNEL_CELLS];
+    uint8_t peerLists[KERNEL_CELLS][KERNEL_CELLS - 1];
+    int peerCounts[KERNEL_CELLS];
+};
+
+// The variant of the puzzles being generated, nullptr for classic sudoku. Killer cages change with
+// every solution grid; the workers of a ParallelRemover only read the table.
+extern ConstraintTable *activeVariant;
+
+// Digit masks (bits 1-9) of every set of different digits, by size and sum
+struct CageCombinations {
+    std::vector<uint16_t> masks[KERNEL_SIDE + 1][46];
+
+    CageCombinations();
+};
+
+extern const CageCombinations cageCombinations;
+
+// The rules of a ConstraintTable for the solver templates, see ClassicRules
+struct TableRules {
+    const ConstraintTable *table;
+
+    explicit TableRules(const ConstraintTable *table = nullptr) : table(table) {}
+
+    int peerCount(int cell) const {
+        return table->peerCount(cell);
+    }
+
+    const uint8_t *peers(int cell) const {
+        return table->peers(cell);
+    }
+
+    int unitCount() const {
+        return table->unitCount();
+    }
+
+    const uint8_t *unit(int index) const {
+        return table->unit(index);
+    }
+
+    // Cage sums: the empty cells of a cage keep the digits of the combinations of different digits
+    // that make up the rest of the sum with the candidates of the cage. False on a contradiction.
+    template<typename Board>
+    bool prune(Board &board, bool &changed) const {
+        for (const Cage &cage: table->cages()) {
+            uint16_t placed = 0, available = 0;
+            int rest = cage.sum, empty = 0;
+            for (int i = 0; i < cage.size; ++i) {
+                int cell = cage.cells[i];
+                placed |= (uint16_t) (1u << board.cells[cell]);
+                available |= board.candidates[cell];
+                rest -= board.cells[cell];
+                if (board.cells[cell] == 0) empty++;
+            }
+            if (empty == 0) {
+                if (rest != 0) return false;
+                continue;
+            }
+            if (rest <= 0 || rest > 45) return false;
+            uint16_t allowed = 0;
+            for (uint16_t digits: cageCombinations.masks[empty][rest]) {
+                if (!(digits & placed) && !(digits & ~available)) allowed |= digits;
+            }
+            if (!allowed) return false;
+            for (int i = 0; i < cage.size; ++i) {
+                int cell = cage.cells[i];
+                uint16_t removed = board.candidates[cell] & (uint16_t) ~allowed;
+                if (board.cells[cell] != 0 || !removed) continue;
+                if (!board.eliminate(cell, removed)) return false;
+                changed = true;
+            }
+        }
+        return true;
+    }
+};
+
+// Repetitions in the units the active variant adds, for the fitness
+inline int variantRepetitions(const uint8_t *board) {
+    return activeVariant ? activeVariant->extraRepetitions(board) : 0;
+}